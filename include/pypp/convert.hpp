@@ -0,0 +1,244 @@
+/// Conversions between numbers and strings.
+///
+/// This provides counterparts to the Python `int()`, `float()`, and `str()`
+/// built-in functions for numeric types. Unlike the standard library functions
+/// such as `std::stoi()` and `std::to_string()`, these are independent of the
+/// current locale and do not allocate memory except to return a std::string.
+///
+/// @file
+#ifndef PYPP_CONVERT_HPP
+#define PYPP_CONVERT_HPP
+
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "string.hpp"
+
+
+namespace pypp { namespace convert {
+
+/// Result of a from_chars() conversion.
+///
+struct FromCharsResult {
+    const char* ptr;  ///< first character that was not consumed
+    std::errc ec;     ///< error code, or a default value for success
+};
+
+
+/// Result of a to_chars() conversion.
+///
+struct ToCharsResult {
+    char* ptr;      ///< end of the output
+    std::errc ec;   ///< error code, or a default value for success
+};
+
+
+/// Parse a decimal integer from a range of characters.
+///
+/// This follows the conventions of the C++17 `std::from_chars()` function:
+/// leading whitespace and a `+` sign are not allowed, and parsing stops at the
+/// first character that is not part of the number. On error, `value` is not
+/// modified and `ec` is `std::errc::invalid_argument` if there is no number,
+/// or `std::errc::result_out_of_range` if the number does not fit in `value`.
+///
+/// @param first first position
+/// @param last last position (exclusive)
+/// @param value output value
+/// @return position after the number and error code
+FromCharsResult from_chars(const char* first, const char* last, int& value);
+
+
+/// @overload
+FromCharsResult from_chars(const char* first, const char* last, long& value);
+
+
+/// @overload
+FromCharsResult from_chars(const char* first, const char* last, long long& value);
+
+
+/// @overload
+FromCharsResult from_chars(const char* first, const char* last, unsigned& value);
+
+
+/// @overload
+FromCharsResult from_chars(const char* first, const char* last, unsigned long& value);
+
+
+/// @overload
+FromCharsResult from_chars(const char* first, const char* last, unsigned long long& value);
+
+
+/// Parse a floating point number from a range of characters.
+///
+/// The number is in decimal notation with an optional exponent, or one of
+/// `inf`, `infinity`, or `nan` (case-insensitive). Hexadecimal notation is not
+/// supported. The result is correctly rounded. Other conventions are the same
+/// as for integers, and a number that overflows or underflows to zero is out
+/// of range.
+///
+/// @param first first position
+/// @param last last position (exclusive)
+/// @param value output value
+/// @return position after the number and error code
+FromCharsResult from_chars(const char* first, const char* last, double& value);
+
+
+/// @overload
+FromCharsResult from_chars(const char* first, const char* last, float& value);
+
+
+/// Format an integer as a decimal number.
+///
+/// On error, `ptr` is `last` and `ec` is `std::errc::value_too_large`. The
+/// output is not null-terminated.
+///
+/// @param first first output position
+/// @param last last output position (exclusive)
+/// @param value value to format
+/// @return end of the output and error code
+ToCharsResult to_chars(char* first, char* last, int value);
+
+
+/// @overload
+ToCharsResult to_chars(char* first, char* last, long value);
+
+
+/// @overload
+ToCharsResult to_chars(char* first, char* last, long long value);
+
+
+/// @overload
+ToCharsResult to_chars(char* first, char* last, unsigned value);
+
+
+/// @overload
+ToCharsResult to_chars(char* first, char* last, unsigned long value);
+
+
+/// @overload
+ToCharsResult to_chars(char* first, char* last, unsigned long long value);
+
+
+/// Format a floating point number.
+///
+/// The output is the shortest string that parses back to the same value, using
+/// the same layout as the Python `repr()` function, e.g. `0.1`, `1.0`, and
+/// `1e+16`. Otherwise, this is the same as the integer version.
+///
+/// @param first first output position
+/// @param last last output position (exclusive)
+/// @param value value to format
+/// @return end of the output and error code
+ToCharsResult to_chars(char* first, char* last, double value);
+
+
+/// @overload
+ToCharsResult to_chars(char* first, char* last, float value);
+
+
+/// Parse a number from a string.
+///
+/// Like the Python `int()` and `float()` functions, leading and trailing
+/// whitespace and a leading `+` sign are allowed, but the rest of the string
+/// must be a valid number. Unlike Python, underscores are not allowed as digit
+/// separators.
+///
+/// @tparam T numeric type
+/// @param str string to parse
+/// @return parsed value
+/// @throws std::invalid_argument if the string is not a number
+/// @throws std::out_of_range if the number is out of range for `T`
+template <typename T>
+T parse(str::StringView str) {
+    const auto num(str::view::strip(str));
+    auto first(num.begin());
+    if (num.size() > 1 and *first == '+' and first[1] != '-') {
+        ++first;
+    }
+    T value{};
+    const auto result(from_chars(first, num.end(), value));
+    if (result.ec == std::errc::result_out_of_range) {
+        throw std::out_of_range("number out of range: '" + std::string(str) + "'");
+    }
+    if (result.ec != std::errc() or result.ptr != num.end()) {
+        throw std::invalid_argument("invalid number: '" + std::string(str) + "'");
+    }
+    return value;
+}
+
+
+/// Convert a string to an integer.
+///
+/// This is the equivalent of the Python `int()` function.
+///
+/// @param str string to convert
+/// @return integer value
+/// @throws std::invalid_argument if the string is not an integer
+/// @throws std::out_of_range if the integer is out of range
+long long to_int(str::StringView str);
+
+
+/// Convert a string to a floating point number.
+///
+/// This is the equivalent of the Python `float()` function.
+///
+/// @param str string to convert
+/// @return floating point value
+/// @throws std::invalid_argument if the string is not a number
+/// @throws std::out_of_range if the number is out of range
+double to_float(str::StringView str);
+
+
+/// Convert a number to a string.
+///
+/// This is the equivalent of the Python `str()` function for numbers.
+///
+/// @tparam T numeric type
+/// @param value number to convert
+/// @return string representation
+template <typename T>
+std::string to_str(T value) {
+    char buffer[32];  // enough for any integer or the longest float
+    const auto result(to_chars(buffer, buffer + sizeof(buffer), value));
+    return {buffer, result.ptr};
+}
+
+
+/// Parse the fields of a record as numbers.
+///
+/// This is equivalent to the Python expression
+/// `[int(field) for field in record.split(sep)]` with `T` as the result type,
+/// but fields are parsed in place without any intermediate strings.
+///
+/// @tparam T numeric type
+/// @tparam OutputIt output iterator type
+/// @param record record to split
+/// @param sep field separator, or empty to split on whitespace
+/// @param out output iterator
+/// @return output iterator after the last value
+/// @throws std::invalid_argument if a field is not a number
+/// @throws std::out_of_range if a field is out of range for `T`
+template <typename T, typename OutputIt>
+OutputIt parse_fields(str::StringView record, const std::string& sep, OutputIt out) {
+    auto fields(sep.empty() ? str::isplit(record) : str::isplit(record, sep));
+    for (const auto field: fields) {
+        *out++ = parse<T>(field);
+    }
+    return out;
+}
+
+
+/// @overload
+///
+/// @return parsed values
+template <typename T>
+std::vector<T> parse_fields(str::StringView record, const std::string& sep="") {
+    std::vector<T> values;
+    parse_fields<T>(record, sep, std::back_inserter(values));
+    return values;
+}
+
+}}  // namespace pypp::convert
+
+#endif  // PYPP_CONVERT_HPP
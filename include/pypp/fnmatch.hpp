@@ -0,0 +1,174 @@
+/// Unix shell style pattern matching.
+///
+/// Patterns use the same syntax as the Python fnmatch module: `*` matches any
+/// sequence of characters, `?` matches any single character, `[seq]` matches
+/// any character in `seq`, and `[!seq]` matches any character not in `seq`.
+/// Unlike a path glob, `*` and `?` also match `/` and a leading dot.
+///
+/// @file
+#ifndef PYPP_FNMATCH_HPP
+#define PYPP_FNMATCH_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+#include "string.hpp"
+
+
+namespace pypp { namespace fnmatch {
+
+/// Compiled pattern, or set of patterns.
+///
+/// All patterns are compiled together into a single deterministic automaton
+/// over byte classes, so the cost of matching a name is one table lookup per
+/// character regardless of the number of patterns or wildcards. Pathological
+/// pattern sets whose automaton would be too large are matched by simulating
+/// the patterns instead. A compiled pattern is immutable, so it can be shared
+/// between threads.
+///
+class Pattern {
+public:
+    /// Compile a pattern.
+    ///
+    /// @param pattern shell pattern
+    /// @param ignore_case match letters regardless of case
+    explicit Pattern(const std::string& pattern, bool ignore_case=false);
+
+    /// Compile a set of patterns.
+    ///
+    /// A name matches the set if it matches any of the patterns.
+    ///
+    /// @param patterns shell patterns
+    /// @param ignore_case match letters regardless of case
+    explicit Pattern(const std::vector<std::string>& patterns, bool ignore_case=false);
+
+    /// @overload
+    explicit Pattern(std::initializer_list<std::string> patterns, bool ignore_case=false);
+
+    /// Match a name.
+    ///
+    /// @param name name to match
+    /// @return true if the name matches any pattern
+    bool match(str::StringView name) const {
+        return find(name) >= 0;
+    }
+
+    /// Find the first pattern that matches a name.
+    ///
+    /// Patterns are numbered in the order they were given to the constructor,
+    /// e.g. to select between include and exclude rules.
+    ///
+    /// @param name name to match
+    /// @return index of the first matching pattern, or -1 for no match
+    int find(str::StringView name) const;
+
+    /// Get the number of patterns.
+    ///
+    /// @return pattern count
+    std::size_t size() const;
+
+private:
+    class Nfa;
+
+    std::shared_ptr<const Nfa> nfa_;
+    std::array<std::uint8_t, 256> classes_;  // byte class of each byte
+    std::size_t class_count_{0};
+    std::vector<std::uint32_t> table_;  // state transitions; empty to simulate
+    std::vector<int> accept_;  // first pattern accepted by each state
+    std::uint32_t start_{0};
+
+    /// Compile patterns.
+    ///
+    /// @param patterns shell patterns
+    /// @param ignore_case match letters regardless of case
+    void compile(const std::vector<std::string>& patterns, bool ignore_case);
+};
+
+
+/// Test whether a name matches a pattern.
+///
+/// This is the equivalent of the Python fnmatch.fnmatch() function. Case is
+/// ignored on platforms where file names are not case-sensitive, which does
+/// not include POSIX. Compiled patterns are cached for each thread.
+///
+/// @param name name to test
+/// @param pattern shell pattern
+/// @return true if the name matches
+bool fnmatch(str::StringView name, const std::string& pattern);
+
+
+/// Test whether a name matches a pattern, including case.
+///
+/// This is the equivalent of the Python fnmatch.fnmatchcase() function.
+/// Compiled patterns are cached for each thread.
+///
+/// @param name name to test
+/// @param pattern shell pattern
+/// @return true if the name matches
+bool fnmatchcase(str::StringView name, const std::string& pattern);
+
+
+/// Select the names in a range that match a compiled pattern.
+///
+/// @tparam InputIt input iterator for strings
+/// @param first first name
+/// @param last one past the last name
+/// @param pattern compiled pattern
+/// @return matching names in input order
+template <typename InputIt>
+std::vector<std::string> filter(InputIt first, InputIt last, const Pattern& pattern) {
+    std::vector<std::string> names;
+    for (; first != last; ++first) {
+        if (pattern.match(*first)) {
+            names.emplace_back(*first);
+        }
+    }
+    return names;
+}
+
+
+/// Select the names in a range that match a pattern.
+///
+/// This is the equivalent of the Python fnmatch.filter() function. Case is
+/// handled as for fnmatch().
+///
+/// @tparam InputIt input iterator for strings
+/// @param first first name
+/// @param last one past the last name
+/// @param pattern shell pattern
+/// @return matching names in input order
+template <typename InputIt>
+std::vector<std::string> filter(InputIt first, InputIt last, const std::string& pattern) {
+#if defined(_WIN32)
+    return filter(first, last, Pattern(pattern, true));
+#else
+    return filter(first, last, Pattern(pattern));
+#endif
+}
+
+
+/// Select the names that match a pattern.
+///
+/// @param names names to filter
+/// @param pattern shell pattern
+/// @return matching names in input order
+std::vector<std::string> filter(const std::vector<std::string>& names, const std::string& pattern);
+
+
+/// Translate a pattern to a regular expression.
+///
+/// This is the equivalent of the Python fnmatch.translate() function. The
+/// result uses ECMAScript syntax for `std::regex` and must be matched against
+/// the entire name, e.g. with `std::regex_match()`.
+///
+/// @param pattern shell pattern
+/// @return regular expression
+std::string translate(const std::string& pattern);
+
+}}  // namespace pypp::fnmatch
+
+#endif  // PYPP_FNMATCH_HPP
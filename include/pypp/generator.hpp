@@ -6,9 +6,11 @@
 #ifndef PYPP_GENERATOR_HPP
 #define PYPP_GENERATOR_HPP
 
+#include <cassert>
 #include <exception>
 #include <iterator>
 #include <limits>
+#include <stdexcept>
 #include <tuple>
 #include <utility>
 
@@ -0,0 +1,123 @@
+/**
+ * Unix style pathname pattern expansion.
+ *
+ * @file
+ */
+#ifndef PYPP_GLOB_HPP
+#define PYPP_GLOB_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "pypp/generator.hpp"
+
+
+namespace pypp { namespace glob {
+
+class Pattern;
+
+
+/**
+ * Lazily generate the paths matching a pattern.
+ *
+ * The pattern is compiled once when the generator is created. Use iglob() to
+ * create a generator.
+ */
+class GlobIterator: public generator::Generator<std::string> {
+public:
+    /**
+     * Compile a pattern and generate the first match.
+     *
+     * @param pattern: path pattern
+     * @param recursive: `**` matches any number of directories
+     */
+    GlobIterator(const std::string& pattern, bool recursive);
+
+    /**
+     * Test if the generator is active.
+     *
+     * @return: true if the generator is still active
+     */
+    bool active() const override;
+
+    /**
+     * Get the current value of the generator.
+     *
+     * @return: current path
+     */
+    std::string value() const override;
+
+    /**
+     * Generate the next value.
+     */
+    void next() override;
+
+private:
+    std::shared_ptr<const Pattern> pattern_;
+    std::vector<std::pair<std::string, std::size_t>> pending_;  // directory and segment
+    std::vector<std::string> matches_;  // matches waiting to be generated
+    std::string value_;
+    bool active_{true};
+};
+
+
+/**
+ * Lazily generate the paths matching a pattern.
+ *
+ * This is the equivalent of the Python glob.iglob() function. The pattern
+ * syntax is the same as for fnmatch, and each path segment is matched
+ * separately. Names that start with a dot are only matched by a segment that
+ * also starts with a dot. Literal segments are resolved without listing the
+ * directory. If `recursive` is true, a `**` segment matches zero or more
+ * directories, but symbolic links to directories are not followed. Unlike
+ * Python, a trailing `**` matches everything below a directory but not the
+ * directory itself.
+ *
+ * @param pattern: path pattern
+ * @param recursive: `**` matches any number of directories
+ * @return: generator of matching paths
+ */
+GlobIterator iglob(const std::string& pattern, bool recursive=false);
+
+
+/**
+ * Return the paths matching a pattern.
+ *
+ * This is the equivalent of the Python glob.glob() function. The matching
+ * rules are the same as for iglob(). For a recursive pattern, directories are
+ * read in parallel by a pool of threads. Unlike Python, the result is sorted.
+ *
+ * @param pattern: path pattern
+ * @param recursive: `**` matches any number of directories
+ * @param threads: number of threads, or 0 for the number of CPUs
+ * @return: matching paths
+ */
+std::vector<std::string> glob(const std::string& pattern, bool recursive=false, std::size_t threads=0);
+
+
+/**
+ * Escape all special characters in a path.
+ *
+ * This is the equivalent of the Python glob.escape() function.
+ *
+ * @param path: path to escape
+ * @return: pattern that only matches `path`
+ */
+std::string escape(const std::string& path);
+
+
+/**
+ * Determine if a string contains any pattern characters.
+ *
+ * This is the equivalent of the Python glob.has_magic() function.
+ *
+ * @param pattern: pattern to test
+ * @return: true if the pattern is not a literal
+ */
+bool has_magic(const std::string& pattern);
+
+}}  // namespace pypp::glob
+
+#endif  // PYPP_GLOB_HPP
@@ -6,8 +6,16 @@
 #ifndef PYPP_OS_HPP
 #define PYPP_OS_HPP
 
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
 #include <string>
 #include <vector>
+#include "pypp/generator.hpp"
 
 
 namespace pypp { namespace os {
@@ -40,6 +48,414 @@ void chdir(const std::string& path);
 std::vector<std::string> listdir(const std::string& path=".");
 
 
+/**
+ * File status returned by stat().
+ *
+ * This is the equivalent of the Python os.stat_result type. Timestamps are in
+ * nanoseconds since the epoch.
+ */
+struct stat_result {
+    mode_t st_mode{0};  ///< file type and permissions
+    ino_t st_ino{0};  ///< inode number
+    dev_t st_dev{0};  ///< device
+    nlink_t st_nlink{0};  ///< number of hard links
+    uid_t st_uid{0};  ///< owner user ID
+    gid_t st_gid{0};  ///< owner group ID
+    off_t st_size{0};  ///< size in bytes
+    std::int64_t st_atime_ns{0};  ///< last access time
+    std::int64_t st_mtime_ns{0};  ///< last modification time
+    std::int64_t st_ctime_ns{0};  ///< last status change time
+
+    /**
+     * Default constructor.
+     */
+    stat_result() = default;
+
+    /**
+     * Convert a system status structure.
+     *
+     * @param status: system status
+     */
+    explicit stat_result(const struct stat& status);
+};
+
+
+/**
+ * Get the status of a path.
+ *
+ * This is the equivalent of the Python os.stat() function. A
+ * std::runtime_error is thrown if the path cannot be accessed.
+ *
+ * @param path: file path
+ * @param follow_symlinks: get the status of the target of a symbolic link
+ * @return: file status
+ */
+stat_result stat(const std::string& path, bool follow_symlinks=true);
+
+
+/**
+ * Get the status of a path without following symbolic links.
+ *
+ * This is the equivalent of the Python os.lstat() function.
+ *
+ * @param path: file path
+ * @return: file status
+ */
+stat_result lstat(const std::string& path);
+
+
+/**
+ * Result of stat_many() for one path.
+ */
+struct StatEntry {
+    stat_result status;  ///< file status, only valid if `error` is 0
+    int error{0};  ///< error number, or 0 for success
+};
+
+
+/**
+ * Get the status of many paths.
+ *
+ * On Linux, requests are submitted in batches through io_uring if the kernel
+ * supports it, so many of them are in flight at once. Otherwise, or if the
+ * `PYPP_DISABLE_IO_URING` environment variable is set, blocking calls are
+ * spread across a pool of threads. Unlike stat(), errors are reported for
+ * each entry and do not cause an exception.
+ *
+ * @param paths: file paths
+ * @param follow_symlinks: get the status of the target of a symbolic link
+ * @param threads: number of fallback threads, or 0 for the number of CPUs
+ * @return: results in the same order as `paths`
+ */
+std::vector<StatEntry> stat_many(const std::vector<std::string>& paths, bool follow_symlinks=true,
+                                 std::size_t threads=0);
+
+
+/**
+ * Get the status of a range of paths.
+ *
+ * @tparam InputIt: input iterator type
+ * @param first: first path
+ * @param last: last path (exclusive)
+ * @param follow_symlinks: get the status of the target of a symbolic link
+ * @param threads: number of fallback threads, or 0 for the number of CPUs
+ * @return: results in the same order as the input
+ */
+template <typename InputIt>
+std::vector<StatEntry> stat_many(InputIt first, InputIt last, bool follow_symlinks=true, std::size_t threads=0) {
+    return stat_many(std::vector<std::string>(first, last), follow_symlinks, threads);
+}
+
+
+/**
+ * Directory entry returned by scandir().
+ *
+ * The entry type and inode number are read from the directory itself, so
+ * type tests do not require a system call for most file systems. The result
+ * of stat() is cached on first use. Like Python, the cache is never updated,
+ * and an entry is not safe to use concurrently from multiple threads.
+ */
+class DirEntry {
+public:
+    /**
+     * Default constructor.
+     */
+    DirEntry() = default;
+
+    /**
+     * Create an entry.
+     *
+     * @param dir: parent directory path
+     * @param name: entry name
+     * @param type: entry type (a `DT_*` constant)
+     * @param inode: inode number
+     */
+    DirEntry(const std::string& dir, const char* name, unsigned char type, ino_t inode);
+
+    /**
+     * Get the entry name.
+     *
+     * @return: file name
+     */
+    const std::string& name() const;
+
+    /**
+     * Get the entry path.
+     *
+     * This is the scandir() path joined with the entry name.
+     *
+     * @return: file path
+     */
+    const std::string& path() const;
+
+    /**
+     * Get the inode number of the entry.
+     *
+     * @return: inode number
+     */
+    ino_t inode() const;
+
+    /**
+     * Determine if the entry is a directory.
+     *
+     * This is false if the entry does not exist (anymore).
+     *
+     * @param follow_symlinks: test the target of a symbolic link
+     * @return: true for a directory
+     */
+    bool is_dir(bool follow_symlinks=true) const;
+
+    /**
+     * Determine if the entry is a regular file.
+     *
+     * This is false if the entry does not exist (anymore).
+     *
+     * @param follow_symlinks: test the target of a symbolic link
+     * @return: true for a regular file
+     */
+    bool is_file(bool follow_symlinks=true) const;
+
+    /**
+     * Determine if the entry is a symbolic link.
+     *
+     * @return: true for a symbolic link
+     */
+    bool is_symlink() const;
+
+    /**
+     * Get the status of the entry.
+     *
+     * A std::runtime_error is thrown if the entry cannot be accessed.
+     *
+     * @param follow_symlinks: get the status of the target of a symbolic link
+     * @return: file status
+     */
+    const stat_result& stat(bool follow_symlinks=true) const;
+
+private:
+    std::string name_;
+    std::string path_;
+    unsigned char type_{DT_UNKNOWN};
+    ino_t inode_{0};
+    mutable stat_result stat_;
+    mutable stat_result lstat_;
+    mutable bool has_stat_{false};
+    mutable bool has_lstat_{false};
+
+    /**
+     * Get the cached status of the entry.
+     *
+     * @param follow_symlinks: get the status of the target of a symbolic link
+     * @return: file status, or nullptr on error
+     */
+    const stat_result* status(bool follow_symlinks) const;
+};
+
+
+/**
+ * Lazily generate the entries in a directory.
+ *
+ * The directory is read in large blocks, so memory use is bounded for any
+ * number of entries. Special entries (e.g. "." and "..") are ignored. Use
+ * scandir() to create a generator.
+ */
+class ScandirIterator: public generator::Generator<DirEntry> {
+public:
+    /**
+     * Open a directory for reading.
+     *
+     * @param path: directory path
+     */
+    explicit ScandirIterator(const std::string& path);
+
+    /**
+     * Move constructor.
+     *
+     * @param other: generator to move from
+     */
+    ScandirIterator(ScandirIterator&& other) noexcept;
+
+    ScandirIterator(const ScandirIterator&) = delete;
+
+    ScandirIterator& operator=(const ScandirIterator&) = delete;
+
+    /**
+     * Close the directory.
+     */
+    ~ScandirIterator();
+
+    /**
+     * Test if the generator is active.
+     *
+     * @return: true if the generator is still active
+     */
+    bool active() const override;
+
+    /**
+     * Get the current value of the generator.
+     *
+     * @return: current entry
+     */
+    DirEntry value() const override;
+
+    /**
+     * Generate the next value.
+     */
+    void next() override;
+
+private:
+    std::string path_;
+    int fd_;
+    DIR* dir_{nullptr};
+    std::vector<char> buffer_;
+    std::size_t pos_{0};
+    std::size_t end_{0};
+    DirEntry entry_;
+    bool active_{true};
+
+    /**
+     * Read the next entry from the directory.
+     *
+     * @return: false at the end of the directory
+     */
+    bool read();
+};
+
+
+/**
+ * Lazily generate the entries in a directory.
+ *
+ * This is the equivalent of the Python os.scandir() function. Unlike
+ * listdir(), each entry includes its type, so it is more efficient to use this
+ * for filtering or walking a directory tree.
+ *
+ * @param path: directory path
+ * @return: entry generator
+ */
+ScandirIterator scandir(const std::string& path=".");
+
+
+/**
+ * Directory contents generated by walk().
+ */
+struct WalkEntry {
+    std::string dirpath;  ///< directory path
+    std::vector<std::string> dirnames;  ///< names of subdirectories
+    std::vector<std::string> filenames;  ///< names of non-directories
+};
+
+
+/**
+ * Error handler for walk().
+ *
+ * The argument is the error for a directory that could not be read.
+ */
+using WalkError = std::function<void(const std::runtime_error&)>;
+
+
+/**
+ * Lazily generate the contents of a directory tree.
+ *
+ * Use walk() to create a generator.
+ */
+class WalkIterator: public generator::Generator<WalkEntry> {
+public:
+    /**
+     * Create a generator.
+     *
+     * @param top: root directory
+     * @param topdown: generate a directory before its subdirectories
+     * @param onerror: error handler, or nullptr to ignore errors
+     * @param followlinks: walk into symbolic links to directories
+     */
+    WalkIterator(const std::string& top, bool topdown, WalkError onerror, bool followlinks);
+
+    /**
+     * Test if the generator is active.
+     *
+     * @return: true if the generator is still active
+     */
+    bool active() const override;
+
+    /**
+     * Get the current value of the generator.
+     *
+     * @return: current directory contents
+     */
+    WalkEntry value() const override;
+
+    /**
+     * Generate the next value.
+     */
+    void next() override;
+
+    /**
+     * Access the subdirectory names of the current directory.
+     *
+     * For a top-down walk, names can be removed from this list to prevent the
+     * generator from visiting those subdirectories, or it can be reordered to
+     * change the order in which they are visited. Like Python, this has no
+     * effect for a bottom-up walk.
+     *
+     * @return: mutable subdirectory names
+     */
+    std::vector<std::string>& dirnames();
+
+private:
+    struct Frame {
+        WalkEntry entry;
+        std::vector<std::string> subdirs;
+        std::size_t next;
+    };
+
+    bool topdown_;
+    WalkError onerror_;
+    bool followlinks_;
+    std::vector<std::string> links_;
+    std::vector<std::string> pending_;
+    std::vector<Frame> frames_;
+    WalkEntry entry_;
+    bool active_{true};
+};
+
+
+/**
+ * Lazily generate the contents of a directory tree.
+ *
+ * This is the equivalent of the Python os.walk() function. Directory types
+ * are determined by scandir(), so most entries do not require a stat() call.
+ * Errors are reported to `onerror`, and the directory is skipped.
+ *
+ * @param top: root directory
+ * @param topdown: generate a directory before its subdirectories
+ * @param onerror: error handler, or nullptr to ignore errors
+ * @param followlinks: walk into symbolic links to directories
+ * @return: directory generator
+ */
+WalkIterator walk(const std::string& top, bool topdown=true, WalkError onerror=nullptr, bool followlinks=false);
+
+
+/**
+ * Walk a directory tree in parallel.
+ *
+ * This is a parallel version of a top-down walk(). Directories are read by a
+ * pool of threads, and the callback is called for each directory as soon as
+ * it has been read. The callback can remove names from `dirnames` to prevent
+ * walking into those subdirectories. The callback and the error handler are
+ * called concurrently from multiple threads in no particular order, so they
+ * must be thread-safe. If either of them throws an exception, the walk stops
+ * and the first exception is rethrown.
+ *
+ * @param top: root directory
+ * @param callback: called with the contents of each directory
+ * @param onerror: error handler, or nullptr to ignore errors
+ * @param followlinks: walk into symbolic links to directories
+ * @param threads: number of threads, or 0 to use the number of CPUs
+ */
+void walk_parallel(const std::string& top, const std::function<void(WalkEntry&)>& callback,
+                   WalkError onerror=nullptr, bool followlinks=false, std::size_t threads=0);
+
+
 /**
  * Recursively make a new directory.
  *
@@ -8,6 +8,16 @@
 #ifndef PYPP_PATH_HPP
 #define PYPP_PATH_HPP
 
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+#include "pypp/generator.hpp"
+#include "pypp/string.hpp"
+
 #define PYPP_POSIX_SEP '/'
 #define PYPP_WINDOWS_SEP '\\'
 
@@ -148,8 +158,59 @@ bool isdir(const std::string& path);
 bool islink(const std::string& path);
 
 
+/**
+ * Lazily generate the ancestors of a path.
+ *
+ * Each ancestor is a view of a prefix of the original path, so the path must
+ * remain valid while the generator is in use. The direct parent comes first,
+ * and the last ancestor is the root for an absolute path or `.` for a
+ * relative path. Like dirname(), trailing separators are ignored, but the
+ * path is not otherwise normalized.
+ */
+class Ancestors: public generator::Generator<str::StringView> {
+public:
+    /**
+     * Create a generator.
+     *
+     * @param path: input path
+     * @param sep: path separator
+     */
+    Ancestors(str::StringView path, char sep);
+
+    /**
+     * Test if the generator is active.
+     *
+     * @return: true if the generator is still active
+     */
+    bool active() const override;
+
+    /**
+     * Get the current value of the generator.
+     *
+     * @return: current ancestor
+     */
+    str::StringView value() const override;
+
+    /**
+     * Generate the next value.
+     */
+    void next() override;
+
+private:
+    char sep_;
+    str::StringView value_;
+    bool active_{true};
+};
+
+
 /**
  * Base class for system-independent path representations.
+ *
+ * The normalized path is stored as a single string, so a short path does not
+ * require any heap allocations, and a long path requires exactly one.
+ * Components are located by scanning for separators when they are needed.
+ * The hash of the path is computed on first use and cached, so paths can be
+ * used as keys in unordered containers without rehashing the string.
  */
 template <char SEP>
 class PureBasePath {
@@ -163,8 +224,58 @@ public:
      */
     explicit operator std::string() const;
 
+    /**
+     * Copy constructor.
+     *
+     * @param other: path to copy
+     */
+    PureBasePath(const PureBasePath& other);
+
+    /**
+     * Move constructor.
+     *
+     * @param other: path to move
+     */
+    PureBasePath(PureBasePath&& other) noexcept;
+
+    /**
+     * Copy assignment.
+     *
+     * @param other: path to copy
+     * @return: this path
+     */
+    PureBasePath& operator=(const PureBasePath& other);
+
+    /**
+     * Move assignment.
+     *
+     * @param other: path to move
+     * @return: this path
+     */
+    PureBasePath& operator=(PureBasePath&& other) noexcept;
+
     virtual ~PureBasePath() = default;
 
+    /**
+     * Compute a hash value for the path.
+     *
+     * The value is computed on the first call and cached until the path is
+     * modified. Equal paths have equal hashes.
+     *
+     * @return hash value
+     */
+    std::size_t hash() const;
+
+    /**
+     * Lazily generate all ancestor paths, starting with the direct parent.
+     *
+     * Each value is a view of the stored path, so this path must remain valid
+     * while the generator is in use.
+     *
+     * @return ancestor generator
+     */
+    Ancestors ancestors() const;
+
     /**
      * Determine if the path is absolute.
      *
@@ -182,9 +293,11 @@ public:
     /**
      * Split the path into its component parts.
      *
+     * The parts are not stored, so they are created on every call.
+     *
      * @return path parts
      */
-    const std::vector<std::string>& parts() const { return parts_; }
+    std::vector<std::string> parts() const;
 
     /**
      * Get the path root.
@@ -215,8 +328,11 @@ public:
     std::vector<std::string> suffixes() const;
 
 protected:
-    /** @property: path components */
-    std::vector<std::string> parts_;
+    /** @property: normalized path */
+    std::string path_;
+
+    /** @property: cached hash value, or zero if not computed */
+    mutable std::atomic<std::size_t> hash_{0};
 
     /**
      * Create a path object.
@@ -237,6 +353,16 @@ protected:
      */
     short compare(const PureBasePath& other) const;
 
+    /**
+     * Test paths for equality.
+     *
+     * This is faster than compare() for unequal paths whose hashes have
+     * already been computed.
+     *
+     * @return: true if the paths are equal
+     */
+    bool equals(const PureBasePath& other) const;
+
     /**
      * Determine if path is a relative (`.`) or absolute root.
      *
@@ -244,6 +370,42 @@ protected:
      */
     bool is_root() const;
 
+    /**
+     * Get the position of the final path component.
+     *
+     * @return: string position
+     */
+    std::string::size_type name_pos() const;
+
+    /**
+     * Remove the final path component.
+     *
+     * This is for use by derived classes to implement their parent() method.
+     */
+    void pop_name();
+
+    /**
+     * Join another path to this path in place.
+     *
+     * This is for use by derived classes to implement their joinpath() and
+     * `/=` operator methods. The components of a relative path are appended
+     * to the existing path without renormalizing it unless the other path
+     * contains a parent reference. An absolute path replaces this path.
+     *
+     * @param other: path to join
+     */
+    void append(const std::string& other);
+
+    /**
+     * Set the path from a sequence of parts.
+     *
+     * This is the inverse of parts().
+     *
+     * @param first: first part
+     * @param last: last part (exclusive)
+     */
+    void set_parts(std::vector<std::string>::const_iterator first, std::vector<std::string>::const_iterator last);
+
     /**
      * Set the path name.
      *
@@ -488,9 +650,72 @@ public:
 };
 
 
+/**
+ * Replace the suffix of each path in a range.
+ *
+ * This is equivalent to calling `with_suffix()` for each path, e.g. to derive
+ * output file names from a list of input files. It works with any path type.
+ *
+ * @param first: first path
+ * @param last: last path (exclusive)
+ * @param suffix: new suffix
+ * @param out: output iterator
+ * @return: output iterator after the last path
+ */
+template <typename InputIt, typename OutputIt>
+OutputIt with_suffix(InputIt first, InputIt last, const std::string& suffix, OutputIt out) {
+    for (; first != last; ++first) {
+        *out++ = first->with_suffix(suffix);
+    }
+    return out;
+}
+
+
+/**
+ * Replace the suffix of each path in a sequence.
+ *
+ * @param paths: input paths
+ * @param suffix: new suffix
+ * @return: paths with the new suffix
+ */
+template <typename Path>
+std::vector<Path> with_suffix(const std::vector<Path>& paths, const std::string& suffix) {
+    std::vector<Path> result;
+    result.reserve(paths.size());
+    with_suffix(paths.begin(), paths.end(), suffix, std::back_inserter(result));
+    return result;
+}
+
+
 }}  // namespace pypp::path
 
 
+namespace std {
+
+/**
+ * Hash function for PurePosixPath.
+ */
+template <>
+struct hash<pypp::path::PurePosixPath> {
+    std::size_t operator()(const pypp::path::PurePosixPath& path) const {
+        return path.hash();
+    }
+};
+
+
+/**
+ * Hash function for PureWindowsPath.
+ */
+template <>
+struct hash<pypp::path::PureWindowsPath> {
+    std::size_t operator()(const pypp::path::PureWindowsPath& path) const {
+        return path.hash();
+    }
+};
+
+}  // namespace std
+
+
 #if defined (__unix__) || (defined (__APPLE__) && defined (__MACH__))
 // POSIX implementation.
 #include "pypp/posix/path.hpp"
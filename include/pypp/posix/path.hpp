@@ -8,15 +8,301 @@
 #ifndef PYPP_POSIX_PATH_HPP
 #define PYPP_POSIX_PATH_HPP
 
+#include <sys/mman.h>
+#include <cstddef>
 #include <fstream>
 #include <string>
 #include <utility>
 #include <vector>
+#include "pypp/generator.hpp"
+#include "pypp/os.hpp"
 #include "pypp/path.hpp"
+#include "pypp/string.hpp"
 
 
 namespace pypp { namespace path {
 
+/// Lazily read lines from a file.
+///
+/// The file is read in fixed-size blocks, and each line is yielded as a view
+/// into the internal buffer. A view is only valid until the generator is
+/// advanced, so copy it to a std::string if it needs to be retained. Lines
+/// are split as for str::splitlines(). Memory use is bounded by the buffer
+/// size, which is only increased for a line that does not fit in it. Use
+/// PosixPath::lines() to create a generator.
+///
+class LineReader: public generator::Generator<str::StringView> {
+public:
+    /// Default buffer size.
+    ///
+    static const std::size_t default_buffer_size;
+
+    /// Open a file for reading.
+    ///
+    /// @param path file path
+    /// @param keepends keep line endings in the result
+    /// @param buffer_size initial buffer size
+    LineReader(const std::string& path, bool keepends, std::size_t buffer_size=default_buffer_size);
+
+    /// Move constructor.
+    ///
+    /// @param other generator to move from
+    LineReader(LineReader&& other) noexcept;
+
+    LineReader(const LineReader&) = delete;
+
+    LineReader& operator=(const LineReader&) = delete;
+
+    /// Close the file.
+    ///
+    ~LineReader();
+
+    /// Test if the generator is active.
+    ///
+    /// @return true if the generator is still active
+    bool active() const override;
+
+    /// Get the current value of the generator.
+    ///
+    /// The result is only valid if the generator is active, and only until the
+    /// generator is advanced.
+    ///
+    /// @return current line
+    str::StringView value() const override;
+
+    /// Generate the next value.
+    ///
+    void next() override;
+
+private:
+    std::string path_;
+    int fd_;
+    bool keepends_;
+    bool eof_{false};
+    bool active_{true};
+    std::vector<char> buffer_;
+    std::size_t beg_{0};
+    std::size_t end_{0};
+    str::StringView line_;
+
+    /// Read the next block from the file.
+    ///
+    /// Unconsumed data is moved to the front of the buffer first, and the
+    /// buffer is enlarged if it is already full.
+    ///
+    /// @param scan position where the line ending search will resume
+    /// @return updated scan position
+    std::size_t fill(std::size_t scan);
+};
+
+
+/// Test if a file status is for a regular file.
+///
+/// @param status file status
+/// @return true for a regular file
+bool isfile(const os::stat_result& status);
+
+
+/// Test if a file status is for a directory.
+///
+/// @param status file status
+/// @return true for a directory
+bool isdir(const os::stat_result& status);
+
+
+/// Test if a file status is for a symbolic link.
+///
+/// @param status file status
+/// @return true for a symbolic link
+bool islink(const os::stat_result& status);
+
+
+/// Cached file status for a path.
+///
+/// This is the equivalent of the Python pathlib.Path.info attribute. The
+/// status is queried on first use and is never updated, so any number of
+/// predicates can be tested with one system call, or two for a symbolic link.
+/// Like os::DirEntry, this is not safe to use concurrently from multiple
+/// threads. Use PosixPath::info() to create a snapshot.
+///
+class PathInfo {
+public:
+    /// Create a snapshot for a path.
+    ///
+    /// @param path file path
+    explicit PathInfo(std::string path);
+
+    /// Test if the path exists.
+    ///
+    /// @param follow_symlinks test the target of a symbolic link
+    /// @return true if the path exists
+    bool exists(bool follow_symlinks=true) const;
+
+    /// Test if the path is a directory.
+    ///
+    /// @param follow_symlinks test the target of a symbolic link
+    /// @return true for an existing directory
+    bool is_dir(bool follow_symlinks=true) const;
+
+    /// Test if the path is a regular file.
+    ///
+    /// @param follow_symlinks test the target of a symbolic link
+    /// @return true for an existing file
+    bool is_file(bool follow_symlinks=true) const;
+
+    /// Test if the path is a symbolic link.
+    ///
+    /// @return true for a symbolic link
+    bool is_symlink() const;
+
+    /// Get the file status.
+    ///
+    /// A std::runtime_error is thrown if the path cannot be accessed.
+    ///
+    /// @param follow_symlinks get the status of the target of a symbolic link
+    /// @return file status
+    const os::stat_result& stat(bool follow_symlinks=true) const;
+
+private:
+    std::string path_;
+    mutable os::stat_result stat_;
+    mutable os::stat_result lstat_;
+    mutable int stat_error_{-1};  // -1 until queried, then errno
+    mutable int lstat_error_{-1};
+
+    /// Get the cached status.
+    ///
+    /// @param follow_symlinks get the status of the target of a symbolic link
+    /// @return file status, or nullptr on error
+    const os::stat_result* status(bool follow_symlinks) const;
+};
+
+
+/// Buffered file writer.
+///
+/// Data is collected in a buffer of a fixed size, and written to the file when
+/// the buffer would overflow. The buffered data and the record that did not
+/// fit are written together with a single writev() call, so a large record is
+/// never copied into the buffer. Any remaining data is written when the writer
+/// is closed or destroyed, but errors are only reported by an explicit
+/// flush() or close(). Use PosixPath::writer() to create a writer.
+///
+class FileWriter {
+public:
+    /// Default buffer size.
+    ///
+    static const std::size_t default_buffer_size;
+
+    /// Open a file for writing.
+    ///
+    /// @param path file path
+    /// @param append append to an existing file instead of truncating it
+    /// @param buffer_size buffer size
+    FileWriter(const std::string& path, bool append=false, std::size_t buffer_size=default_buffer_size);
+
+    /// Move constructor.
+    ///
+    /// @param other object to move from
+    FileWriter(FileWriter&& other) noexcept;
+
+    FileWriter(const FileWriter&) = delete;
+
+    FileWriter& operator=(const FileWriter&) = delete;
+
+    /// Write any buffered data and close the file.
+    ///
+    ~FileWriter();
+
+    /// Write data to the file.
+    ///
+    /// @param data data to write
+    void write(str::StringView data);
+
+    /// Write a sequence of records.
+    ///
+    /// Like the Python writelines() method, line endings are not added.
+    ///
+    /// @tparam InputIt input iterator type
+    /// @param first first record
+    /// @param last last record (exclusive)
+    template <typename InputIt>
+    void writelines(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            write(*first);
+        }
+        return;
+    }
+
+    /// Write any buffered data to the file.
+    ///
+    void flush();
+
+    /// Write any buffered data and close the file.
+    ///
+    /// Closing a closed file has no effect.
+    ///
+    void close();
+
+private:
+    std::string path_;
+    int fd_;
+    std::size_t capacity_;
+    std::string buffer_;
+};
+
+
+/// Read-only memory map of a file.
+///
+/// This gives zero-copy access to the contents of a regular file. The mapping
+/// is private, so changes made to the file after it has been mapped may or may
+/// not be visible. A file that reports a size of zero, e.g. a procfs file, is
+/// mapped as empty; use PosixPath::read_bytes() for those.
+///
+class MappedFile {
+public:
+    /// Map a file.
+    ///
+    /// @param path file path
+    /// @param advice expected access pattern (a `MADV_*` constant)
+    explicit MappedFile(const std::string& path, int advice=MADV_SEQUENTIAL);
+
+    /// Move constructor.
+    ///
+    /// @param other object to move from
+    MappedFile(MappedFile&& other) noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// Unmap the file.
+    ///
+    ~MappedFile();
+
+    /// Get the file contents.
+    ///
+    /// @return view of the mapped data
+    str::StringView view() const;
+
+    /// Get a pointer to the file contents.
+    ///
+    /// @return mapped data, or nullptr for an empty file
+    const char* data() const;
+
+    /// Get the size of the file.
+    ///
+    /// @return size in bytes
+    std::size_t size() const;
+
+    /// Give the kernel a hint about the expected access pattern.
+    ///
+    /// @param advice access pattern (a `MADV_*` constant)
+    void advise(int advice) const;
+
+private:
+    const char* data_{nullptr};
+    std::size_t size_{0};
+};
 
 
 ///
@@ -42,7 +328,7 @@ public:
     /// Split the path into its component parts.
     ///
     /// @return path parts
-    const std::vector<std::string>& parts() const;
+    std::vector<std::string> parts() const;
 
     /// Get the path root (`` or `/`).
     ///
@@ -128,6 +414,14 @@ public:
     /// @return true if path is less than other
     bool operator<(const PosixPath& other) const;
 
+    /// Compute a hash value for the path.
+    ///
+    /// This is the same as the hash of the equivalent PurePosixPath, and is
+    /// cached after the first call.
+    ///
+    /// @return hash value
+    std::size_t hash() const;
+
     /// Compute the direct parent path.
     ///
     /// @return parent path
@@ -138,6 +432,14 @@ public:
     /// @return ancestor paths
     std::vector<PosixPath> parents() const;
 
+    /// Lazily generate all ancestor paths, starting with the direct parent.
+    ///
+    /// Each value is a view of the stored path, so this path must remain valid
+    /// while the generator is in use.
+    ///
+    /// @return ancestor generator
+    Ancestors ancestors() const;
+
     /// Compute a relative path.
     ///
     /// @param other parent path
@@ -158,6 +460,27 @@ public:
     ///
     PurePosixPath pure() const;
 
+    /// Get the status of this path.
+    ///
+    /// A std::runtime_error is thrown if the path cannot be accessed.
+    ///
+    /// @param follow_symlinks get the status of the target of a symbolic link
+    /// @return file status
+    os::stat_result stat(bool follow_symlinks=true) const;
+
+    /// Get the status of this path without following symbolic links.
+    ///
+    /// @return file status
+    os::stat_result lstat() const;
+
+    /// Get a cached snapshot of the status of this path.
+    ///
+    /// Each predicate below queries the file system again, so use this to
+    /// test more than one of them.
+    ///
+    /// @return path information
+    PathInfo info() const;
+
     /// Test for the existence of the path.
     ///
     /// @return true if this is an existing file or directory.
@@ -218,6 +541,10 @@ public:
 
     /// Read binary data from a file with this path.
     ///
+    /// A regular file is read directly into a result of the expected size.
+    /// Other files, e.g. pipes, are read in blocks until EOF. Use MappedFile
+    /// for large files that do not need to be copied.
+    ///
     /// @return binary data
     std::string read_bytes() const;
 
@@ -229,6 +556,17 @@ public:
     /// @return file contents
     std::string read_text() const;
 
+    /// Lazily read lines from a file with this path.
+    ///
+    /// This is analogous to iterating over a Python file object, but each line
+    /// is a view that is only valid until the generator is advanced. Lines are
+    /// read in blocks, so the file does not need to fit in memory.
+    ///
+    /// @param keepends keep line endings in the result
+    /// @param buffer_size initial read buffer size
+    /// @return generator of lines
+    LineReader lines(bool keepends=false, std::size_t buffer_size=LineReader::default_buffer_size) const;
+
     /// Write binary data to a file with this path.
     ///
     /// If the file already exists it will be overwritten.
@@ -244,6 +582,16 @@ public:
     /// @param data: file contents
     void write_text(const std::string& data) const;
 
+    /// Open a buffered writer for a file with this path.
+    ///
+    /// Unlike open(), this bypasses iostreams, and the buffer size can be
+    /// tuned for the size of the records being written.
+    ///
+    /// @param append append to an existing file instead of truncating it
+    /// @param buffer_size buffer size
+    /// @return file writer
+    FileWriter writer(bool append=false, std::size_t buffer_size=FileWriter::default_buffer_size) const;
+
     /// List all items in the directory with this path.
     ///
     /// Unlike Python, this returns a complete sequence, not a generator.
@@ -251,14 +599,42 @@ public:
     /// @return
     std::vector<PosixPath> iterdir() const;
 
+    /// Lazily generate the entries in the directory with this path.
+    ///
+    /// Unlike iterdir(), this yields each entry with its type. This is the
+    /// equivalent of the Python os.scandir() function for this path.
+    ///
+    /// @return entry generator
+    os::ScandirIterator scandir() const;
+
+    /// Return the paths matching a pattern relative to this path.
+    ///
+    /// This is the equivalent of the Python Path.glob() method. The pattern
+    /// syntax is the same as for glob::glob(), and `**` always matches any
+    /// number of directories. Unlike Python, the result is sorted.
+    ///
+    /// @param pattern relative path pattern
+    /// @return matching paths
+    std::vector<PosixPath> glob(const std::string& pattern) const;
+
+    /// Recursively return the paths matching a pattern relative to this path.
+    ///
+    /// This is the same as calling glob() with `**/` prepended to the pattern.
+    ///
+    /// @param pattern relative path pattern
+    /// @return matching paths
+    std::vector<PosixPath> rglob(const std::string& pattern) const;
+
 private:
     PurePosixPath base_;
 
     /// Read file contents.
     ///
-    /// @param mode file mode
+    /// There is no distinction between text and binary files on POSIX
+    /// platforms.
+    ///
     /// @return file contents
-    std::string read_file(const std::string& mode) const;
+    std::string read_file() const;
 
     /// Write file contents.
     ///
@@ -269,4 +645,18 @@ private:
 
 }}  // namespace pypp::path
 
+
+namespace std {
+
+/// Hash function for PosixPath.
+///
+template <>
+struct hash<pypp::path::PosixPath> {
+    std::size_t operator()(const pypp::path::PosixPath& path) const {
+        return path.hash();
+    }
+};
+
+}  // namespace std
+
 #endif  // PYPP_POSIX_PATH_HPP
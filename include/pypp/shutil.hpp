@@ -0,0 +1,37 @@
+/**
+ * High-level file operations.
+ *
+ * @file
+ */
+#ifndef PYPP_SHUTIL_HPP
+#define PYPP_SHUTIL_HPP
+
+#include <cstddef>
+#include <string>
+
+
+namespace pypp { namespace shutil {
+
+/**
+ * Recursively delete a directory tree.
+ *
+ * This is the equivalent of the Python shutil.rmtree() function. Directories
+ * are opened relative to their parent's file descriptor, and entries are
+ * removed by name using the types reported by the directory itself, so no
+ * full paths are built and no stat() calls are needed for most file systems.
+ * Symbolic links are removed, not followed, and it is an error for `path`
+ * itself to be a symbolic link.
+ *
+ * For wide trees, files can be removed by a pool of threads. Directories are
+ * still opened relative to their parent in this mode, and the empty
+ * directories are removed serially once all files are gone.
+ *
+ * @param path: directory path
+ * @param ignore_errors: ignore errors instead of throwing an exception
+ * @param threads: number of threads, or 0 to use the hardware concurrency
+ */
+void rmtree(const std::string& path, bool ignore_errors=false, std::size_t threads=1);
+
+}}  // namespace pypp::shutil
+
+#endif  // PYPP_SHUTIL_HPP
@@ -6,8 +6,21 @@
 #ifndef PYPP_STRING_HPP
 #define PYPP_STRING_HPP
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
+#include "generator.hpp"
+
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
 
 
 namespace pypp { namespace str {
@@ -19,8 +32,166 @@ namespace pypp { namespace str {
 extern const std::string whitespace;
 
 
+/// Non-owning reference to a sequence of characters.
+///
+/// This is a minimal C++11 counterpart to `std::string_view`, which it can be
+/// implicitly converted to and from when compiling for C++17 or later. A view
+/// does not own its data, so it is only valid for the lifetime of the string
+/// or buffer it was created from.
+///
+class StringView {
+public:
+    using size_type = std::size_t;
+    using const_iterator = const char*;
+    using iterator = const_iterator;
+
+    /// Special value for the end of a string.
+    static const size_type npos = static_cast<size_type>(-1);
+
+    /// Create an empty view.
+    ///
+    StringView() = default;
+
+    /// Create a view of a buffer.
+    ///
+    /// @param data first character
+    /// @param size number of characters
+    StringView(const char* data, size_type size): data_(data), size_(size) {}
+
+    /// Create a view of a null-terminated string.
+    ///
+    /// @param str input string
+    StringView(const char* str): data_(str), size_(std::strlen(str)) {}
+
+    /// Create a view of a std::string.
+    ///
+    /// @param str input string
+    StringView(const std::string& str): data_(str.data()), size_(str.size()) {}
+
+#if __cplusplus >= 201703L
+    /// Create a view of a std::string_view.
+    ///
+    /// @param str input string
+    StringView(std::string_view str): data_(str.data()), size_(str.size()) {}
+
+    /// Convert to a std::string_view.
+    ///
+    /// @return string view
+    operator std::string_view() const { return {data_, size_}; }
+#endif
+
+    /// Copy the viewed characters to a new string.
+    ///
+    /// @return string
+    explicit operator std::string() const { return {data_, size_}; }
+
+    /// Get a pointer to the first character.
+    ///
+    /// The viewed characters are not guaranteed to be null-terminated.
+    ///
+    /// @return data pointer
+    const char* data() const { return data_; }
+
+    /// Get the number of characters.
+    ///
+    /// @return size
+    size_type size() const { return size_; }
+
+    /// @overload
+    size_type length() const { return size_; }
+
+    /// Test if the view is empty.
+    ///
+    /// @return true for an empty view
+    bool empty() const { return size_ == 0; }
+
+    /// Get an iterator to the first character.
+    ///
+    /// @return iterator
+    const_iterator begin() const { return data_; }
+
+    /// Get an iterator past the last character.
+    ///
+    /// @return iterator
+    const_iterator end() const { return data_ + size_; }
+
+    /// Access a character without bounds checking.
+    ///
+    /// @param pos character position
+    /// @return character
+    char operator[](size_type pos) const { return data_[pos]; }
+
+    /// Get a view of a substring.
+    ///
+    /// @param pos first position
+    /// @param count maximum number of characters
+    /// @return substring view
+    StringView substr(size_type pos, size_type count=npos) const {
+        if (pos > size_) {
+            throw std::out_of_range("position is out of range");
+        }
+        return {data_ + pos, std::min(count, size_ - pos)};
+    }
+
+    /// Lexical comparison.
+    ///
+    /// @param other view to compare
+    /// @return negative, zero, or positive like std::string::compare()
+    int compare(StringView other) const {
+        const auto cmp(std::memcmp(data_, other.data_, std::min(size_, other.size_)));
+        if (cmp != 0) {
+            return cmp;
+        }
+        return size_ == other.size_ ? 0 : (size_ < other.size_ ? -1 : 1);
+    }
+
+    /// Equality operator.
+    ///
+    /// @param lhs left operand
+    /// @param rhs right operand
+    /// @return true if operands have the same characters
+    friend bool operator==(StringView lhs, StringView rhs) {
+        return lhs.size_ == rhs.size_ and lhs.compare(rhs) == 0;
+    }
+
+    /// Inequality operator.
+    ///
+    /// @param lhs left operand
+    /// @param rhs right operand
+    /// @return true if operands do not have the same characters
+    friend bool operator!=(StringView lhs, StringView rhs) {
+        return not (lhs == rhs);
+    }
+
+    /// Less-than operator.
+    ///
+    /// @param lhs left operand
+    /// @param rhs right operand
+    /// @return true if lhs is lexically less than rhs
+    friend bool operator<(StringView lhs, StringView rhs) {
+        return lhs.compare(rhs) < 0;
+    }
+
+    /// Stream insertion operator.
+    ///
+    /// @param stream output stream
+    /// @param view view to insert
+    /// @return output stream
+    friend std::ostream& operator<<(std::ostream& stream, StringView view) {
+        return stream.write(view.data_, static_cast<std::streamsize>(view.size_));
+    }
+
+private:
+    const char* data_{nullptr};
+    size_type size_{0};
+};
+
+
 /// Convert a character to lower case.
 ///
+/// Like all case conversions in this module, this only affects the ASCII
+/// character set and is not locale-aware.
+///
 /// @param c input char
 /// @return lower-case char
 char lower(char c);
@@ -33,6 +204,25 @@ char lower(char c);
 std::string lower(std::string str);
 
 
+/// Convert a range of characters to lower case in place.
+///
+/// @param first first position
+/// @param last last position (exclusive)
+void lower(char* first, char* last);
+
+
+/// Convert a range of characters to lower case in an output buffer.
+///
+/// The output buffer must be able to hold `last - first` characters. It may be
+/// the same as the input buffer, but the two must not otherwise overlap.
+///
+/// @param first first input position
+/// @param last last input position (exclusive)
+/// @param out first output position
+/// @return last output position (exclusive)
+char* lower(const char* first, const char* last, char* out);
+
+
 /// Convert a char to upper case.
 ///
 /// @param c input char
@@ -47,12 +237,119 @@ char upper(char c);
 std::string upper(std::string str);
 
 
+/// Convert a range of characters to upper case in place.
+///
+/// @param first first position
+/// @param last last position (exclusive)
+void upper(char* first, char* last);
+
+
+/// Convert a range of characters to upper case in an output buffer.
+///
+/// The output buffer must be able to hold `last - first` characters. It may be
+/// the same as the input buffer, but the two must not otherwise overlap.
+///
+/// @param first first input position
+/// @param last last input position (exclusive)
+/// @param out first output position
+/// @return last output position (exclusive)
+char* upper(const char* first, const char* last, char* out);
+
+
+/// Set of characters.
+///
+/// This is a 256-bit bitmap with one bit for every possible char value. A set
+/// can be created at compile time from a string literal, and membership tests
+/// are constant time.
+///
+class CharSet {
+public:
+    /// Create an empty set.
+    ///
+    constexpr CharSet(): bits_{0, 0, 0, 0} {}
+
+    /// Create a set from a null-terminated string.
+    ///
+    /// @param chars set members
+    constexpr explicit CharSet(const char* chars):
+        bits_{word(chars, 0), word(chars, 1), word(chars, 2), word(chars, 3)} {}
+
+    /// Create a set from a string.
+    ///
+    /// Unlike the null-terminated version, this can include `\0`.
+    ///
+    /// @param chars set members
+    explicit CharSet(StringView chars): bits_{0, 0, 0, 0} {
+        for (const auto c: chars) {
+            const auto byte(static_cast<unsigned char>(c));
+            bits_[byte >> 6] |= std::uint64_t{1} << (byte & 63);
+        }
+    }
+
+    /// Test if a character is in the set.
+    ///
+    /// @param c character to test
+    /// @return true if the character is a member
+    constexpr bool contains(char c) const {
+        return (bits_[static_cast<unsigned char>(c) >> 6] >> (static_cast<unsigned char>(c) & 63)) & 1;
+    }
+
+    /// Get the underlying bitmap.
+    ///
+    /// Bit `n % 64` of word `n / 64` corresponds to the char value `n`.
+    ///
+    /// @return array of four 64-bit words
+    const std::uint64_t* bitmap() const { return bits_; }
+
+private:
+    std::uint64_t bits_[4];
+
+    /// Compute one word of the bitmap for a null-terminated string.
+    ///
+    /// This is recursive in order to be a C++11 constant expression.
+    ///
+    /// @param chars set members
+    /// @param index word index
+    /// @return bitmap word
+    static constexpr std::uint64_t word(const char* chars, unsigned index) {
+        return *chars == '\0' ? 0 : (
+            (static_cast<unsigned char>(*chars) >> 6 == index ? std::uint64_t{1} << (static_cast<unsigned char>(*chars) & 63) : 0)
+            | word(chars + 1, index));
+    }
+};
+
+
+/// Set of whitespace characters.
+///
+/// This contains the same characters as `whitespace`.
+///
+constexpr CharSet whitespace_set(" \t\n\v\f\r");
+
+
 /// Remove leading characters from a string.
 ///
 /// @param str input string
 /// @param chars set of characters to remove
 /// @return modified string
-std::string lstrip(const std::string& str, const std::string& chars=whitespace);
+std::string lstrip(const std::string& str, const CharSet& chars=whitespace_set);
+
+
+/// @overload
+std::string lstrip(const std::string& str, const std::string& chars);
+
+
+/// Remove leading characters from a temporary string.
+///
+/// The string is modified in place, so no memory is allocated.
+///
+/// @param str input string
+/// @param chars set of characters to remove
+/// @return modified string
+std::string lstrip(std::string&& str, const CharSet& chars=whitespace_set);
+
+
+/// @overload
+std::string lstrip(std::string&& str, const std::string& chars);
 
 
 /// Remove trailing characters from a string.
@@ -60,7 +357,25 @@ std::string lstrip(const std::string& str, const std::string& chars=whitespace);
 /// @param str input string
 /// @param chars set of characters to remove
 /// @return modified string
-std::string rstrip(const std::string& str, const std::string& chars=whitespace);
+std::string rstrip(const std::string& str, const CharSet& chars=whitespace_set);
+
+
+/// @overload
+std::string rstrip(const std::string& str, const std::string& chars);
+
+
+/// Remove trailing characters from a temporary string.
+///
+/// The string is modified in place, so no memory is allocated.
+///
+/// @param str input string
+/// @param chars set of characters to remove
+/// @return modified string
+std::string rstrip(std::string&& str, const CharSet& chars=whitespace_set);
+
+
+/// @overload
+std::string rstrip(std::string&& str, const std::string& chars);
 
 
 /// Remove leading and trailing characters from of a string.
@@ -70,7 +385,25 @@ std::string rstrip(const std::string& str, const std::string& chars=whitespace);
 /// @param str input string
 /// @param chars set of characters to remove
 /// @return modified string
-std::string strip(const std::string& str, const std::string& chars=whitespace);
+std::string strip(const std::string& str, const CharSet& chars=whitespace_set);
+
+
+/// @overload
+std::string strip(const std::string& str, const std::string& chars);
+
+
+/// Remove leading and trailing characters from a temporary string.
+///
+/// The string is modified in place, so no memory is allocated.
+///
+/// @param str input string
+/// @param chars set of characters to remove
+/// @return modified string
+std::string strip(std::string&& str, const CharSet& chars=whitespace_set);
+
+
+/// @overload
+std::string strip(std::string&& str, const std::string& chars);
 
 
 /**
@@ -80,7 +413,6 @@ std::string strip(const std::string& str, const std::string& chars=whitespace);
  * @param sep: separator
  * @return: joined values
  */
-// TODO: take iterators?
 std::string join(const std::vector<std::string>& items, const std::string& sep="");
 
 
@@ -88,6 +420,166 @@ std::string join(const std::vector<std::string>& items, const std::string& sep="
 std::string join(const std::vector<std::string>& items, char sep);
 
 
+namespace detail {
+
+/**
+ * Compute the length of a joined sequence.
+ *
+ * @tparam IT: forward iterator type
+ * @param first: first position
+ * @param last: last position (exclusive)
+ * @param seplen: separator length
+ * @return: joined length
+ */
+template <typename IT>
+std::size_t join_size(IT first, IT last, std::size_t seplen, std::forward_iterator_tag) {
+    std::size_t size(0);
+    std::size_t count(0);
+    for (; first != last; ++first, ++count) {
+        size += StringView(*first).size();
+    }
+    return count == 0 ? 0 : size + (count - 1) * seplen;
+}
+
+
+/**
+ * Compute the length of a joined sequence.
+ *
+ * The length of an input sequence cannot be known in advance, so this always
+ * returns zero.
+ *
+ * @tparam IT: input iterator type
+ * @return: zero
+ */
+template <typename IT>
+std::size_t join_size(IT, IT, std::size_t, std::input_iterator_tag) {
+    return 0;
+}
+
+
+/**
+ * Pass each item and separator of a joined sequence to a sink.
+ *
+ * @tparam IT: input iterator type
+ * @tparam Sink: callable type that accepts a StringView
+ * @param first: first position
+ * @param last: last position (exclusive)
+ * @param sep: separator
+ * @param sink: output sink
+ */
+template <typename IT, typename Sink>
+void join_each(IT first, IT last, StringView sep, Sink sink) {
+    if (first == last) {
+        return;
+    }
+    sink(StringView(*first));
+    for (++first; first != last; ++first) {
+        // Skip first element to avoid leading delimiter.
+        sink(sep);
+        sink(StringView(*first));
+    }
+    return;
+}
+
+}  // namespace detail
+
+
+/**
+ * Join strings using a separator and append them to an existing string.
+ *
+ * Items can be any type that is convertible to a StringView, e.g. a
+ * std::string or a string literal. For forward iterators the final size is
+ * computed in advance so that the output is allocated no more than once. Input
+ * iterators, e.g. from a generator, are joined in a single pass.
+ *
+ * @tparam IT: input iterator type
+ * @param out: output string
+ * @param first: first position
+ * @param last: last position (exclusive)
+ * @param sep: separator
+ * @return: output string
+ */
+template <typename IT>
+std::string& join(std::string& out, IT first, IT last, StringView sep="") {
+    using category = typename std::iterator_traits<IT>::iterator_category;
+    const auto size(detail::join_size(first, last, sep.size(), category()));
+    out.reserve(out.size() + size);
+    detail::join_each(first, last, sep, [&out](StringView item) {
+        out.append(item.data(), item.size());
+    });
+    return out;
+}
+
+
+/**
+ * Join strings using a separator and write them to a stream.
+ *
+ * @tparam IT: input iterator type
+ * @param out: output stream
+ * @param first: first position
+ * @param last: last position (exclusive)
+ * @param sep: separator
+ * @return: output stream
+ */
+template <typename IT>
+std::ostream& join(std::ostream& out, IT first, IT last, StringView sep="") {
+    detail::join_each(first, last, sep, [&out](StringView item) {
+        out.write(item.data(), static_cast<std::streamsize>(item.size()));
+    });
+    return out;
+}
+
+
+/**
+ * Join strings using a separator and write them to a fixed buffer.
+ *
+ * A std::length_error is thrown if the buffer is too small. For forward
+ * iterators this is checked before anything is written. The output is not
+ * null-terminated.
+ *
+ * @tparam IT: input iterator type
+ * @param out: first output position
+ * @param out_last: last output position (exclusive)
+ * @param first: first position
+ * @param last: last position (exclusive)
+ * @param sep: separator
+ * @return: last output position (exclusive)
+ */
+template <typename IT>
+char* join(char* out, char* out_last, IT first, IT last, StringView sep="") {
+    using category = typename std::iterator_traits<IT>::iterator_category;
+    static const std::length_error error("buffer is too small");
+    const auto size(detail::join_size(first, last, sep.size(), category()));
+    if (size > static_cast<std::size_t>(out_last - out)) {
+        throw error;
+    }
+    detail::join_each(first, last, sep, [&out, out_last](StringView item) {
+        if (item.size() > static_cast<std::size_t>(out_last - out)) {
+            throw error;
+        }
+        out = std::copy(item.begin(), item.end(), out);
+    });
+    return out;
+}
+
+
+/**
+ * Join strings using a separator.
+ *
+ * @tparam IT: input iterator type
+ * @param first: first position
+ * @param last: last position (exclusive)
+ * @param sep: separator
+ * @return: joined values
+ */
+template <typename IT>
+std::string join(IT first, IT last, StringView sep="") {
+    std::string joined;
+    join(joined, first, last, sep);
+    return joined;
+}
+
+
 /// Split a string on whitespace.
 ///
 /// If `maxsplit` is non-negative, a maximum of that many splits will be
@@ -122,7 +614,8 @@ std::vector<std::string> split(const std::string& str, const std::string& sep, s
 /// performed, and the first item will contain the remainder of the string
 /// regardless of any whitespace it contains.
 ///
-/// Leading and trailing whitespace is ignored.
+/// Leading and trailing whitespace is ignored. Use irsplit() to generate items
+/// in reverse order without splitting the entire string.
 ///
 /// @param str string to split
 /// @param maxsplit maximum number of splits to perform
@@ -137,7 +630,8 @@ std::vector<std::string> rsplit(const std::string& str, ssize_t maxsplit=-1);
 ///
 /// If `maxsplit` is non-negative, a maximum of that many splits will be
 /// performed, and the first item will contain the remainder of the string
-/// regardless of any separators it contains.
+/// regardless of any separators it contains. Use irsplit() to generate items
+/// in reverse order without splitting the entire string.
 ///
 /// @param str string to split
 /// @param sep separator to split on
@@ -146,6 +640,213 @@ std::vector<std::string> rsplit(const std::string& str, ssize_t maxsplit=-1);
 std::vector<std::string> rsplit(const std::string& str, const std::string& sep, ssize_t maxsplit=-1);
 
 
+/// Lazily split a string from left to right.
+///
+/// This yields views into the original string, which must remain valid for
+/// the lifetime of the generator. Use isplit() to create a generator.
+///
+class SplitGenerator: public generator::Generator<StringView> {
+public:
+    /// Create a generator.
+    ///
+    /// @param str string to split
+    /// @param sep separator to split on, or empty to split on whitespace
+    /// @param maxsplit maximum number of splits to perform
+    SplitGenerator(StringView str, std::string sep, ssize_t maxsplit);
+
+    /// Test if the generator is active.
+    ///
+    /// @return true if the generator is still active
+    bool active() const override;
+
+    /// Get the current value of the generator.
+    ///
+    /// The result is only valid if the generator is active.
+    ///
+    /// @return current item
+    StringView value() const override;
+
+    /// Generate the next value.
+    ///
+    void next() override;
+
+private:
+    StringView str_;
+    std::string sep_;
+    ssize_t maxsplit_;
+    ssize_t count_{0};
+    StringView::size_type beg_{0};
+    StringView::size_type end_{0};
+
+    /// Find the end of the item starting at the current position.
+    ///
+    void find();
+};
+
+
+/// Lazily split a string from right to left.
+///
+/// Items are yielded in reverse order, i.e. the last item in the string is
+/// yielded first. This yields views into the original string, which must
+/// remain valid for the lifetime of the generator. Use irsplit() to create a
+/// generator.
+///
+class RSplitGenerator: public generator::Generator<StringView> {
+public:
+    /// Create a generator.
+    ///
+    /// @param str string to split
+    /// @param sep separator to split on, or empty to split on whitespace
+    /// @param maxsplit maximum number of splits to perform
+    RSplitGenerator(StringView str, std::string sep, ssize_t maxsplit);
+
+    /// Test if the generator is active.
+    ///
+    /// @return true if the generator is still active
+    bool active() const override;
+
+    /// Get the current value of the generator.
+    ///
+    /// The result is only valid if the generator is active.
+    ///
+    /// @return current item
+    StringView value() const override;
+
+    /// Generate the next value.
+    ///
+    void next() override;
+
+private:
+    StringView str_;
+    std::string sep_;
+    ssize_t maxsplit_;
+    ssize_t count_{0};
+    StringView::size_type beg_{0};
+    StringView::size_type end_{0};
+    bool last_{false};
+
+    /// Find the beginning of the item ending at the current position.
+    ///
+    void find();
+};
+
+
+/// Lazily split a string on whitespace.
+///
+/// This is the lazy counterpart to split(). No memory is allocated for the
+/// items, which are views into the original string. The string must remain
+/// valid for the lifetime of the generator.
+///
+/// @param str string to split
+/// @param maxsplit maximum number of splits to perform
+/// @return generator of split items
+SplitGenerator isplit(StringView str, ssize_t maxsplit=-1);
+
+
+/// Lazily split a string on a separator.
+///
+/// This is the lazy counterpart to split(). No memory is allocated for the
+/// items, which are views into the original string. The string must remain
+/// valid for the lifetime of the generator.
+///
+/// @param str string to split
+/// @param sep separator to split on
+/// @param maxsplit maximum number of splits to perform
+/// @return generator of split items
+SplitGenerator isplit(StringView str, const std::string& sep, ssize_t maxsplit=-1);
+
+
+/// Lazily split a string on whitespace starting from the right.
+///
+/// This is the lazy counterpart to rsplit(), but items are generated in
+/// reverse order. This is useful for retrieving the last few items of a
+/// string without splitting the entire string.
+///
+/// @param str string to split
+/// @param maxsplit maximum number of splits to perform
+/// @return generator of split items in reverse order
+RSplitGenerator irsplit(StringView str, ssize_t maxsplit=-1);
+
+
+/// Lazily split a string on a separator starting from the right.
+///
+/// This is the lazy counterpart to rsplit(), but items are generated in
+/// reverse order. This is useful for retrieving the last few items of a
+/// string without splitting the entire string.
+///
+/// @param str string to split
+/// @param sep separator to split on
+/// @param maxsplit maximum number of splits to perform
+/// @return generator of split items in reverse order
+RSplitGenerator irsplit(StringView str, const std::string& sep, ssize_t maxsplit=-1);
+
+
+/// Split a string into lines.
+///
+/// Lines are terminated by `\n`, `\r\n`, or `\r`. Unlike split(), a trailing
+/// line ending does not generate an empty item. Like the Python version for
+/// `bytes`, other Unicode line boundaries are not recognized.
+///
+/// @param str string to split
+/// @param keepends keep line endings in the result
+/// @return lines
+std::vector<std::string> splitlines(const std::string& str, bool keepends=false);
+
+
+/// Lazily split a string into lines.
+///
+/// This yields views into the original string, which must remain valid for
+/// the lifetime of the generator. Use isplitlines() to create a generator.
+///
+class LineGenerator: public generator::Generator<StringView> {
+public:
+    /// Create a generator.
+    ///
+    /// @param str string to split
+    /// @param keepends keep line endings in the result
+    LineGenerator(StringView str, bool keepends);
+
+    /// Test if the generator is active.
+    ///
+    /// @return true if the generator is still active
+    bool active() const override;
+
+    /// Get the current value of the generator.
+    ///
+    /// The result is only valid if the generator is active.
+    ///
+    /// @return current line
+    StringView value() const override;
+
+    /// Generate the next value.
+    ///
+    void next() override;
+
+private:
+    StringView str_;
+    bool keepends_;
+    StringView::size_type beg_{0};
+    StringView::size_type end_{0};
+    StringView::size_type eol_{0};
+
+    /// Find the end of the line starting at the current position.
+    ///
+    void find();
+};
+
+
+/// Lazily split a string into lines.
+///
+/// This is the lazy counterpart to splitlines(). No memory is allocated for
+/// the lines, which are views into the original string. The string must
+/// remain valid for the lifetime of the generator.
+///
+/// @param str string to split
+/// @param keepends keep line endings in the result
+/// @return generator of lines
+LineGenerator isplitlines(StringView str, bool keepends=false);
+
+
 /**
  * Determine if a string starts with a prefix.
  *
@@ -180,6 +881,67 @@ bool endswith(const std::string& str, const std::string& suffix);
 bool endswith(const std::string& str, char prefix);
 
 
+/// Find the first occurrence of a substring.
+///
+/// Unlike the Python version, this does not support optional beginning and
+/// ending positions for the search. Use a substring view as needed instead.
+///
+/// @param str string to search
+/// @param sub substring to find
+/// @return position of the substring, or -1 if not found
+ssize_t find(StringView str, StringView sub);
+
+
+/// Find the last occurrence of a substring.
+///
+/// @param str string to search
+/// @param sub substring to find
+/// @return position of the substring, or -1 if not found
+ssize_t rfind(StringView str, StringView sub);
+
+
+/// Find the first occurrence of a substring that must exist.
+///
+/// This is like find(), but a std::invalid_argument exception is thrown if
+/// the substring is not found.
+///
+/// @param str string to search
+/// @param sub substring to find
+/// @return position of the substring
+std::size_t index(StringView str, StringView sub);
+
+
+/// Find the last occurrence of a substring that must exist.
+///
+/// This is like rfind(), but a std::invalid_argument exception is thrown if
+/// the substring is not found.
+///
+/// @param str string to search
+/// @param sub substring to find
+/// @return position of the substring
+std::size_t rindex(StringView str, StringView sub);
+
+
+/// Count the non-overlapping occurrences of a substring.
+///
+/// An empty substring matches between every character.
+///
+/// @param str string to search
+/// @param sub substring to count
+/// @return number of occurrences
+std::size_t count(StringView str, StringView sub);
+
+
+/// Determine if a string contains a substring.
+///
+/// This is the equivalent of the Python `in` operator for strings.
+///
+/// @param str string to search
+/// @param sub substring to find
+/// @return true if the substring is found
+bool contains(StringView str, StringView sub);
+
+
 /// Replace all occurrences of text in a string.
 ///
 /// @param str input string
@@ -190,6 +952,87 @@ bool endswith(const std::string& str, char prefix);
 std::string replace(std::string str, const std::string& old, const std::string& sub, ssize_t maxcount=-1);
 
 
+/// Compiled set of substitutions for replacing multiple patterns at once.
+///
+/// The patterns are compiled into an Aho-Corasick automaton so that a string
+/// can be searched for all of them in a single pass.
+///
+class Replacer {
+public:
+    /// Compile a set of substitutions.
+    ///
+    /// Patterns must not be empty. If a pattern appears more than once, the
+    /// last substitution for it is used.
+    ///
+    /// @param subs (pattern, substitution) pairs
+    explicit Replacer(const std::vector<std::pair<std::string, std::string>>& subs);
+
+private:
+    friend std::string replace(const std::string& str, const Replacer& replacer, ssize_t maxcount);
+
+    std::array<std::uint16_t, 256> classes_;  // up to 257 classes
+    std::size_t nclasses_;
+    std::vector<std::uint32_t> delta_;
+    std::vector<std::uint32_t> depth_;
+    std::vector<std::int32_t> match_;
+    std::vector<std::string> subs_;
+    std::vector<std::size_t> lengths_;
+};
+
+
+/// Replace all occurrences of multiple patterns in a string.
+///
+/// The string is scanned once from left to right. Where patterns overlap, the
+/// leftmost match is replaced, and the longest pattern is used for matches
+/// that start at the same position. Replacement text is not rescanned.
+///
+/// @param str input string
+/// @param replacer compiled substitutions
+/// @param maxcount maximum number of substitutions
+/// @return modified string
+std::string replace(const std::string& str, const Replacer& replacer, ssize_t maxcount=-1);
+
+
+/// Character translation table for use with translate().
+///
+/// Use maketrans() to create a table.
+///
+class TranslationTable {
+public:
+    /// Create an identity table.
+    ///
+    TranslationTable();
+
+private:
+    friend TranslationTable maketrans(const std::string& from, const std::string& to, const std::string& del);
+    friend std::string translate(std::string str, const TranslationTable& table);
+
+    std::array<std::int16_t, 256> table_;
+    bool deletes_{false};
+};
+
+
+/// Create a translation table.
+///
+/// Each character in `from` is mapped to the character at the same position
+/// in `to`, and every character in `del` is deleted. Unlike Python, mapping
+/// a character to a multi-character string is not supported.
+///
+/// @param from characters to map
+/// @param to mapped characters; must be the same length as `from`
+/// @param del characters to delete
+/// @return translation table
+TranslationTable maketrans(const std::string& from, const std::string& to, const std::string& del="");
+
+
+/// Translate the characters in a string.
+///
+/// @param str input string
+/// @param table translation table created by maketrans()
+/// @return translated string
+std::string translate(std::string str, const TranslationTable& table);
+
+
 /// Pad both sides of string to center it.
 ///
 /// If the amount of padding is not even, the extra fill character will be on
@@ -201,6 +1044,103 @@ std::string replace(std::string str, const std::string& old, const std::string&
 /// @return padded string
 std::string center(const std::string& str, size_t width, char fill=' ');
 
+
+/// Functions that operate on views instead of strings.
+///
+/// These are counterparts to the functions of the same name in the parent
+/// namespace. Inputs are views, so callers holding a `const char*` or a slice
+/// of a string do not need to allocate a temporary std::string, and results
+/// are views into the input wherever possible. The input must remain valid for
+/// the lifetime of any views that refer to it.
+///
+/// When compiled as C++17 or later, StringView is interchangeable with
+/// `std::string_view` for both arguments and return values.
+///
+namespace view {
+
+/// Remove leading characters from a view.
+///
+/// @param str input view
+/// @param chars set of characters to remove
+/// @return view of the remaining characters
+StringView lstrip(StringView str, const CharSet& chars=whitespace_set);
+
+
+/// Remove trailing characters from a view.
+///
+/// @param str input view
+/// @param chars set of characters to remove
+/// @return view of the remaining characters
+StringView rstrip(StringView str, const CharSet& chars=whitespace_set);
+
+
+/// Remove leading and trailing characters from a view.
+///
+/// @param str input view
+/// @param chars set of characters to remove
+/// @return view of the remaining characters
+StringView strip(StringView str, const CharSet& chars=whitespace_set);
+
+
+/// Split a view on whitespace.
+///
+/// @param str view to split
+/// @param maxsplit maximum number of splits to perform
+/// @return views of the split items
+std::vector<StringView> split(StringView str, ssize_t maxsplit=-1);
+
+
+/// Split a view on a separator.
+///
+/// @param str view to split
+/// @param sep separator to split on
+/// @param maxsplit maximum number of splits to perform
+/// @return views of the split items
+std::vector<StringView> split(StringView str, StringView sep, ssize_t maxsplit=-1);
+
+
+/// Split a view on whitespace starting from the right.
+///
+/// @param str view to split
+/// @param maxsplit maximum number of splits to perform
+/// @return views of the split items
+std::vector<StringView> rsplit(StringView str, ssize_t maxsplit=-1);
+
+
+/// Split a view on a separator starting from the right.
+///
+/// @param str view to split
+/// @param sep separator to split on
+/// @param maxsplit maximum number of splits to perform
+/// @return views of the split items
+std::vector<StringView> rsplit(StringView str, StringView sep, ssize_t maxsplit=-1);
+
+
+/// Split a view into lines.
+///
+/// @param str view to split
+/// @param keepends keep line endings in the result
+/// @return views of the lines
+std::vector<StringView> splitlines(StringView str, bool keepends=false);
+
+
+/// Determine if a view starts with a prefix.
+///
+/// @param str view to test
+/// @param prefix prefix to match
+/// @return true if the view begins with the prefix
+bool startswith(StringView str, StringView prefix);
+
+
+/// Determine if a view ends with a suffix.
+///
+/// @param str view to test
+/// @param suffix suffix to match
+/// @return true if the view ends with the suffix
+bool endswith(StringView str, StringView suffix);
+
+}  // namespace view
+
 }}  // namespace
 
 #endif  // PYPP_STRING_HPP 
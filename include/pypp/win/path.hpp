@@ -38,7 +38,7 @@ public:
     /// Split the path into its component parts.
     ///
     /// @return path parts
-    const std::vector<std::string>& parts() const;
+    std::vector<std::string> parts() const;
 
     /// Get the path root (`` or `/`).
     ///
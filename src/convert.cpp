@@ -0,0 +1,675 @@
+/// Implementation of the convert module.
+///
+#include <cerrno>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include "pypp/convert.hpp"
+
+#if defined (__unix__) || (defined (__APPLE__) && defined (__MACH__))
+#define PYPP_CONVERT_STRTOD_L
+#include <locale.h>
+#if defined (__APPLE__)
+#include <xlocale.h>
+#endif
+#else
+#include <locale>
+#include <sstream>
+#endif
+
+#if defined (__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define PYPP_CONVERT_SWAR
+#endif
+
+
+using std::errc;
+using std::is_signed;
+using std::make_unsigned;
+using std::numeric_limits;
+using std::string;
+using std::uint32_t;
+using std::uint64_t;
+
+using namespace pypp;
+using convert::FromCharsResult;
+using convert::ToCharsResult;
+
+
+namespace {
+
+/// Test if a character is a decimal digit.
+///
+/// @param c character to test
+/// @return true for a digit
+inline bool is_digit(char c) {
+    return static_cast<unsigned char>(c - '0') < 10;
+}
+
+
+#ifdef PYPP_CONVERT_SWAR
+
+/// Load 8 characters as a little-endian 64-bit word.
+///
+/// @param pos first position
+/// @return word
+inline uint64_t load8(const char* pos) {
+    uint64_t word;
+    std::memcpy(&word, pos, sizeof(word));
+    return word;
+}
+
+
+/// Test if all 8 characters in a word are decimal digits.
+///
+/// @param word characters loaded by load8()
+/// @return true if every character is a digit
+inline bool is_digits8(uint64_t word) {
+    // Every byte must be 0x30-0x39, i.e. the high nibble must be 3, and it
+    // must still be 3 after adding 6 to the low nibble.
+    return ((word & 0xf0f0f0f0f0f0f0f0) | (((word + 0x0606060606060606) & 0xf0f0f0f0f0f0f0f0) >> 4))
+        == 0x3333333333333333;
+}
+
+
+/// Convert 8 decimal digits to an integer.
+///
+/// This combines adjacent digits into pairs, then pairs into groups of four,
+/// then the two groups, using three multiplications instead of eight.
+///
+/// @param word characters loaded by load8()
+/// @return integer value
+inline uint32_t parse8(uint64_t word) {
+    word -= 0x3030303030303030;
+    word = word * 10 + (word >> 8);
+    word = (((word & 0x000000ff000000ff) * (100 + (1000000ull << 32)))
+        + (((word >> 16) & 0x000000ff000000ff) * (1 + (10000ull << 32)))) >> 32;
+    return static_cast<uint32_t>(word);
+}
+
+#endif  // PYPP_CONVERT_SWAR
+
+
+/// Parse a sequence of decimal digits.
+///
+/// @param first first position
+/// @param last last position (exclusive)
+/// @param value output value
+/// @param overflow set to true if the value does not fit in 64 bits
+/// @return position after the last digit
+const char* parse_digits(const char* first, const char* last, uint64_t& value, bool& overflow) {
+    value = 0;
+    overflow = false;
+#ifdef PYPP_CONVERT_SWAR
+    // Multiplying by 10^8 cannot overflow while the value has at most 11
+    // digits, so the checks below are only needed for the last few digits.
+    static const uint64_t swar_max((numeric_limits<uint64_t>::max() - 99999999) / 100000000);
+    while (last - first >= 8 and value <= swar_max) {
+        const auto word(load8(first));
+        if (not is_digits8(word)) {
+            break;
+        }
+        value = value * 100000000 + parse8(word);
+        first += 8;
+    }
+#endif
+    for (; first != last and is_digit(*first); ++first) {
+        const auto digit(static_cast<unsigned>(*first - '0'));
+        if (__builtin_mul_overflow(value, 10, &value) or __builtin_add_overflow(value, digit, &value)) {
+            overflow = true;
+        }
+    }
+    return first;
+}
+
+
+/// Parse a decimal integer.
+///
+/// @tparam T integer type
+/// @param first first position
+/// @param last last position (exclusive)
+/// @param value output value
+/// @return position after the number and error code
+template <typename T>
+FromCharsResult parse_integer(const char* first, const char* last, T& value) {
+    using Unsigned = typename make_unsigned<T>::type;
+    auto pos(first);
+    const auto negative(is_signed<T>::value and pos != last and *pos == '-');
+    if (negative) {
+        ++pos;
+    }
+    uint64_t magnitude;
+    bool overflow;
+    const auto end(parse_digits(pos, last, magnitude, overflow));
+    if (end == pos) {
+        return {first, errc::invalid_argument};
+    }
+    const auto limit(static_cast<uint64_t>(numeric_limits<T>::max()) + (negative ? 1 : 0));
+    if (overflow or magnitude > limit) {
+        return {end, errc::result_out_of_range};
+    }
+    const auto bits(static_cast<Unsigned>(magnitude));
+    value = static_cast<T>(negative ? Unsigned(0) - bits : bits);
+    return {end, errc()};
+}
+
+
+/// Traits for floating point parsing and formatting.
+///
+/// @tparam T floating point type
+template <typename T>
+struct FloatTraits;
+
+
+/// Traits for double.
+///
+template <>
+struct FloatTraits<double> {
+    static constexpr uint64_t exact_max = uint64_t{1} << 53;  ///< largest exact mantissa
+    static constexpr int exact_pow10 = 22;  ///< largest exact power of 10
+    static constexpr int min_digits = 15;   ///< digits that always round trip
+    static constexpr int max_digits = 17;   ///< digits needed for any value
+
+#ifdef PYPP_CONVERT_STRTOD_L
+    /// Parse a null-terminated string in the "C" locale.
+    ///
+    static double strto(const char* str, char** end, locale_t locale) {
+        return strtod_l(str, end, locale);
+    }
+#endif
+};
+
+
+/// Traits for float.
+///
+template <>
+struct FloatTraits<float> {
+    static constexpr uint64_t exact_max = uint64_t{1} << 24;
+    static constexpr int exact_pow10 = 10;
+    static constexpr int min_digits = 6;
+    static constexpr int max_digits = 9;
+
+#ifdef PYPP_CONVERT_STRTOD_L
+    /// Parse a null-terminated string in the "C" locale.
+    ///
+    static float strto(const char* str, char** end, locale_t locale) {
+        return strtof_l(str, end, locale);
+    }
+#endif
+};
+
+
+/// Exact powers of 10 for the fast path of parse_float().
+///
+const double powers_of_10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+
+/// Match a case-insensitive keyword.
+///
+/// @param first first position
+/// @param last last position (exclusive)
+/// @param word lower-case keyword
+/// @return true if the range starts with the keyword
+bool match_keyword(const char* first, const char* last, const char* word) {
+    const auto len(std::strlen(word));
+    if (static_cast<size_t>(last - first) < len) {
+        return false;
+    }
+    for (size_t pos(0); pos < len; ++pos) {
+        if ((first[pos] | 0x20) != word[pos]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/// Parse a floating point number from a null-terminated copy of the input.
+///
+/// This is the slow path for inputs that cannot be converted exactly using
+/// floating point arithmetic.
+///
+/// @tparam T floating point type
+/// @param first first position
+/// @param last last position (exclusive)
+/// @param value output value
+/// @return false if the value is out of range
+template <typename T>
+bool parse_float_slow(const char* first, const char* last, T& value) {
+    const string str(first, last);
+#ifdef PYPP_CONVERT_STRTOD_L
+    static const auto locale(newlocale(LC_ALL_MASK, "C", nullptr));
+    errno = 0;
+    const auto result(FloatTraits<T>::strto(str.c_str(), nullptr, locale));
+    if (errno == ERANGE and (result == 0 or std::isinf(result))) {
+        return false;
+    }
+#else
+    std::istringstream stream(str);
+    stream.imbue(std::locale::classic());
+    T result;
+    if (not (stream >> result)) {
+        return false;
+    }
+#endif
+    value = result;
+    return true;
+}
+
+
+/// Parse a floating point number.
+///
+/// The mantissa is accumulated as an integer, and if it and the exponent are
+/// small enough the result is computed with a single correctly rounded
+/// multiplication or division (Clinger's fast path). Other inputs are passed
+/// to the C library in the "C" locale.
+///
+/// @tparam T floating point type
+/// @param first first position
+/// @param last last position (exclusive)
+/// @param value output value
+/// @return position after the number and error code
+template <typename T>
+FromCharsResult parse_float(const char* first, const char* last, T& value) {
+    using Traits = FloatTraits<T>;
+    auto pos(first);
+    const auto negative(pos != last and *pos == '-');
+    if (negative) {
+        ++pos;
+    }
+    if (pos != last and ((*pos | 0x20) == 'i' or (*pos | 0x20) == 'n')) {
+        if (match_keyword(pos, last, "infinity") or match_keyword(pos, last, "inf")) {
+            value = negative ? -numeric_limits<T>::infinity() : numeric_limits<T>::infinity();
+            return {pos + (match_keyword(pos, last, "infinity") ? 8 : 3), errc()};
+        }
+        if (match_keyword(pos, last, "nan")) {
+            value = negative ? -numeric_limits<T>::quiet_NaN() : numeric_limits<T>::quiet_NaN();
+            return {pos + 3, errc()};
+        }
+        return {first, errc::invalid_argument};
+    }
+    uint64_t mantissa(0);
+    int digits(0);  // significant digits in the mantissa
+    long exponent(0);
+    bool truncated(false);
+    const auto int_first(pos);
+    for (; pos != last and is_digit(*pos); ++pos) {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (*pos - '0');
+            digits += mantissa != 0;
+        }
+        else {
+            truncated |= *pos != '0';
+            ++exponent;
+        }
+    }
+    auto ndigits(pos - int_first);
+    if (pos != last and *pos == '.') {
+        const auto frac_first(++pos);
+        for (; pos != last and is_digit(*pos); ++pos) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*pos - '0');
+                digits += mantissa != 0;
+                --exponent;
+            }
+            else {
+                truncated |= *pos != '0';
+            }
+        }
+        ndigits += pos - frac_first;
+    }
+    if (ndigits == 0) {
+        return {first, errc::invalid_argument};
+    }
+    if (pos != last and (*pos | 0x20) == 'e') {
+        // The exponent is only part of the number if it has digits.
+        auto exp_pos(pos + 1);
+        const auto exp_negative(exp_pos != last and *exp_pos == '-');
+        if (exp_pos != last and (*exp_pos == '-' or *exp_pos == '+')) {
+            ++exp_pos;
+        }
+        if (exp_pos != last and is_digit(*exp_pos)) {
+            long exp_value(0);
+            for (; exp_pos != last and is_digit(*exp_pos); ++exp_pos) {
+                // Any larger exponent is out of range anyway.
+                exp_value = std::min(exp_value * 10 + (*exp_pos - '0'), 100000L);
+            }
+            exponent += exp_negative ? -exp_value : exp_value;
+            pos = exp_pos;
+        }
+    }
+#if FLT_EVAL_METHOD == 0
+    if (not truncated and mantissa <= Traits::exact_max
+            and exponent >= -Traits::exact_pow10 and exponent <= Traits::exact_pow10) {
+        // Both operands are exact, so the result is correctly rounded.
+        auto result(static_cast<T>(mantissa));
+        if (exponent < 0) {
+            result /= static_cast<T>(powers_of_10[-exponent]);
+        }
+        else {
+            result *= static_cast<T>(powers_of_10[exponent]);
+        }
+        value = negative ? -result : result;
+        return {pos, errc()};
+    }
+#endif
+    if (mantissa == 0 and not truncated) {
+        value = negative ? -T(0) : T(0);
+        return {pos, errc()};
+    }
+    if (not parse_float_slow(first, pos, value)) {
+        return {pos, errc::result_out_of_range};
+    }
+    return {pos, errc()};
+}
+
+
+/// Pairs of decimal digits for formatting integers two digits at a time.
+///
+const char digit_pairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+
+/// Copy a formatted value to the output.
+///
+/// @param first first output position
+/// @param last last output position (exclusive)
+/// @param str formatted value
+/// @param len length of the formatted value
+/// @return end of the output and error code
+ToCharsResult copy_out(char* first, char* last, const char* str, size_t len) {
+    if (static_cast<size_t>(last - first) < len) {
+        return {last, errc::value_too_large};
+    }
+    std::memcpy(first, str, len);
+    return {first + len, errc()};
+}
+
+
+/// Format an integer.
+///
+/// @tparam T integer type
+/// @param first first output position
+/// @param last last output position (exclusive)
+/// @param value value to format
+/// @return end of the output and error code
+template <typename T>
+ToCharsResult format_integer(char* first, char* last, T value) {
+    using Unsigned = typename make_unsigned<T>::type;
+    const auto negative(is_signed<T>::value and value < 0);
+    auto magnitude(negative ? Unsigned(0) - static_cast<Unsigned>(value) : static_cast<Unsigned>(value));
+    char buffer[24];
+    const auto end(buffer + sizeof(buffer));
+    auto pos(end);
+    while (magnitude >= 100) {
+        const auto pair(digit_pairs + (magnitude % 100) * 2);
+        magnitude /= 100;
+        *--pos = pair[1];
+        *--pos = pair[0];
+    }
+    if (magnitude >= 10) {
+        const auto pair(digit_pairs + magnitude * 2);
+        *--pos = pair[1];
+        *--pos = pair[0];
+    }
+    else {
+        *--pos = static_cast<char>('0' + magnitude);
+    }
+    if (negative) {
+        *--pos = '-';
+    }
+    return copy_out(first, last, pos, end - pos);
+}
+
+
+/// Format an integer mantissa with a number of decimal places.
+///
+/// @param out first output position
+/// @param mantissa integer mantissa
+/// @param places number of decimal places
+/// @return last output position (exclusive)
+char* format_fixed(char* out, double mantissa, int places) {
+    char digits[24];
+    const auto count(static_cast<int>(
+        format_integer(digits, digits + sizeof(digits), static_cast<uint64_t>(mantissa)).ptr - digits));
+    if (places == 0) {
+        out = std::copy(digits, digits + count, out);
+        *out++ = '.';
+        *out++ = '0';
+    }
+    else if (count > places) {
+        out = std::copy(digits, digits + count - places, out);
+        *out++ = '.';
+        out = std::copy(digits + count - places, digits + count, out);
+    }
+    else {
+        *out++ = '0';
+        *out++ = '.';
+        out = std::fill_n(out, places - count, '0');
+        out = std::copy(digits, digits + count, out);
+    }
+    return out;
+}
+
+
+/// Format a floating point number as the shortest round-trip string.
+///
+/// The shortest digit string is found by formatting with increasing precision
+/// until the result parses back to the same value. For normal values, any
+/// shorter string that round trips is recovered from the minimum precision
+/// string by removing trailing zeros.
+///
+/// @tparam T floating point type
+/// @param first first output position
+/// @param last last output position (exclusive)
+/// @param value value to format
+/// @return end of the output and error code
+template <typename T>
+ToCharsResult format_float(char* first, char* last, T value) {
+    using Traits = FloatTraits<T>;
+    if (std::isnan(value)) {
+        return copy_out(first, last, "nan", 3);
+    }
+    char buffer[40];
+    auto pos(buffer);
+    if (std::signbit(value)) {
+        *pos++ = '-';
+        value = -value;
+    }
+    if (std::isinf(value)) {
+        std::memcpy(pos, "inf", 3);
+        return copy_out(first, last, buffer, pos + 3 - buffer);
+    }
+#if FLT_EVAL_METHOD == 0
+    if (value >= static_cast<T>(1e-4) and value < static_cast<T>(1e15)) {
+        // Most values in the range that uses fixed notation have a short
+        // decimal representation. If `value * 10^k` rounds to an integer `m`
+        // such that `m / 10^k` is exactly `value`, then `m` with `k` decimal
+        // places round trips, and the smallest such `k` gives the shortest
+        // string. The division is done the same way as the parse_float() fast
+        // path, so this is a valid round-trip check.
+        for (auto places(0); places <= Traits::exact_pow10; ++places) {
+            const auto scale(static_cast<T>(powers_of_10[places]));
+            const auto scaled(value * scale);
+            if (scaled >= static_cast<T>(Traits::exact_max / 2)) {
+                break;
+            }
+            const auto mantissa(std::nearbyint(scaled));
+            if (mantissa / scale == value) {
+                return copy_out(first, last, buffer, format_fixed(pos, mantissa, places) - buffer);
+            }
+        }
+    }
+#endif
+    char digits[24];
+    size_t ndigits(1);
+    int exponent(0);
+    if (value == 0) {
+        digits[0] = '0';
+    }
+    else {
+        // Subnormal values have less precision, so the shortest string is not
+        // necessarily a prefix of the minimum precision string.
+        const auto min_digits(value < numeric_limits<T>::min() ? 1 : Traits::min_digits);
+        for (auto precision(min_digits); precision <= Traits::max_digits; ++precision) {
+            // The decimal point is locale-dependent, so only the digits and
+            // exponent are extracted from the output.
+            char str[40];
+            std::snprintf(str, sizeof(str), "%.*e", precision - 1, static_cast<double>(value));
+            ndigits = 0;
+            auto chr(str);
+            for (; *chr != 'e'; ++chr) {
+                if (is_digit(*chr)) {
+                    digits[ndigits++] = *chr;
+                }
+            }
+            exponent = std::atoi(chr + 1);
+            while (ndigits > 1 and digits[ndigits - 1] == '0') {
+                --ndigits;
+            }
+            // Verify that the digits round trip.
+            char check[48];
+            std::memcpy(check, digits, ndigits);
+            const auto len(ndigits + std::sprintf(check + ndigits, "e%d", exponent - static_cast<int>(ndigits - 1)));
+            T parsed(0);
+            parse_float(check, check + len, parsed);
+            if (parsed == value) {
+                break;
+            }
+        }
+    }
+    // Use the same layout as the Python repr() function.
+    const auto count(static_cast<int>(ndigits));
+    if (exponent >= -4 and exponent < 16) {
+        if (exponent < 0) {
+            *pos++ = '0';
+            *pos++ = '.';
+            pos = std::fill_n(pos, -exponent - 1, '0');
+            pos = std::copy(digits, digits + ndigits, pos);
+        }
+        else if (exponent >= count - 1) {
+            pos = std::copy(digits, digits + ndigits, pos);
+            pos = std::fill_n(pos, exponent - count + 1, '0');
+            *pos++ = '.';
+            *pos++ = '0';
+        }
+        else {
+            pos = std::copy(digits, digits + exponent + 1, pos);
+            *pos++ = '.';
+            pos = std::copy(digits + exponent + 1, digits + ndigits, pos);
+        }
+    }
+    else {
+        *pos++ = digits[0];
+        if (ndigits > 1) {
+            *pos++ = '.';
+            pos = std::copy(digits + 1, digits + ndigits, pos);
+        }
+        pos += std::sprintf(pos, "e%c%02d", exponent < 0 ? '-' : '+', std::abs(exponent));
+    }
+    return copy_out(first, last, buffer, pos - buffer);
+}
+
+}  // internal linkage
+
+
+FromCharsResult convert::from_chars(const char* first, const char* last, int& value) {
+    return parse_integer(first, last, value);
+}
+
+
+FromCharsResult convert::from_chars(const char* first, const char* last, long& value) {
+    return parse_integer(first, last, value);
+}
+
+
+FromCharsResult convert::from_chars(const char* first, const char* last, long long& value) {
+    return parse_integer(first, last, value);
+}
+
+
+FromCharsResult convert::from_chars(const char* first, const char* last, unsigned& value) {
+    return parse_integer(first, last, value);
+}
+
+
+FromCharsResult convert::from_chars(const char* first, const char* last, unsigned long& value) {
+    return parse_integer(first, last, value);
+}
+
+
+FromCharsResult convert::from_chars(const char* first, const char* last, unsigned long long& value) {
+    return parse_integer(first, last, value);
+}
+
+
+FromCharsResult convert::from_chars(const char* first, const char* last, double& value) {
+    return parse_float(first, last, value);
+}
+
+
+FromCharsResult convert::from_chars(const char* first, const char* last, float& value) {
+    return parse_float(first, last, value);
+}
+
+
+ToCharsResult convert::to_chars(char* first, char* last, int value) {
+    return format_integer(first, last, value);
+}
+
+
+ToCharsResult convert::to_chars(char* first, char* last, long value) {
+    return format_integer(first, last, value);
+}
+
+
+ToCharsResult convert::to_chars(char* first, char* last, long long value) {
+    return format_integer(first, last, value);
+}
+
+
+ToCharsResult convert::to_chars(char* first, char* last, unsigned value) {
+    return format_integer(first, last, value);
+}
+
+
+ToCharsResult convert::to_chars(char* first, char* last, unsigned long value) {
+    return format_integer(first, last, value);
+}
+
+
+ToCharsResult convert::to_chars(char* first, char* last, unsigned long long value) {
+    return format_integer(first, last, value);
+}
+
+
+ToCharsResult convert::to_chars(char* first, char* last, double value) {
+    return format_float(first, last, value);
+}
+
+
+ToCharsResult convert::to_chars(char* first, char* last, float value) {
+    return format_float(first, last, value);
+}
+
+
+long long convert::to_int(str::StringView str) {
+    return parse<long long>(str);
+}
+
+
+double convert::to_float(str::StringView str) {
+    return parse<double>(str);
+}
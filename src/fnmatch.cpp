@@ -0,0 +1,436 @@
+/// Implementation of the fnmatch module.
+///
+#include <algorithm>
+#include <bitset>
+#include <cctype>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include "pypp/fnmatch.hpp"
+
+
+using std::bitset;
+using std::map;
+using std::move;
+using std::size_t;
+using std::string;
+using std::uint32_t;
+using std::unordered_map;
+using std::vector;
+
+using namespace pypp;
+using fnmatch::Pattern;
+using str::StringView;
+
+
+namespace {
+
+/// Maximum number of automaton states.
+///
+/// Each state needs one table entry per byte class. A larger automaton is not
+/// built, and the patterns are simulated instead.
+///
+const size_t max_states(4096);
+
+
+/// Maximum number of compiled patterns cached by each thread.
+///
+const size_t cache_size(256);
+
+
+/// Single step of a compiled pattern.
+///
+/// Literals, `?`, and character sets are all sets of bytes.
+///
+struct Token {
+    enum Kind: unsigned char { SET, STAR, END };
+
+    Kind kind;
+    bitset<256> set;  // bytes matched by a SET
+    int pattern;      // pattern index
+};
+
+
+/// Find the end of a character set.
+///
+/// The set is terminated by the first ']' that is not its first member.
+///
+/// @param pattern shell pattern
+/// @param pos position of the opening '['
+/// @return position of the closing ']', or npos if there is none
+size_t set_end(const string& pattern, size_t pos) {
+    ++pos;
+    if (pos < pattern.size() and pattern[pos] == '!') {
+        ++pos;
+    }
+    if (pos < pattern.size() and pattern[pos] == ']') {
+        ++pos;
+    }
+    return pattern.find(']', pos);
+}
+
+
+/// Add the other case of every letter in a set.
+///
+/// @param set set to update
+void fold(bitset<256>& set) {
+    for (unsigned lower('a'); lower <= 'z'; ++lower) {
+        const auto upper(lower - 'a' + 'A');
+        if (set[lower] or set[upper]) {
+            set.set(lower);
+            set.set(upper);
+        }
+    }
+    return;
+}
+
+
+/// Parse the contents of a character set.
+///
+/// @param chars set contents without the brackets
+/// @param ignore_case match letters regardless of case
+/// @param set output set
+void parse_set(const string& chars, bool ignore_case, bitset<256>& set) {
+    size_t pos(0);
+    auto negate(false);
+    if (not chars.empty() and chars[0] == '!') {
+        negate = true;
+        ++pos;
+    }
+    for (; pos < chars.size(); ++pos) {
+        const unsigned first(static_cast<unsigned char>(chars[pos]));
+        auto last(first);
+        if (pos + 2 < chars.size() and chars[pos + 1] == '-') {
+            // As in Python, a reversed range is empty.
+            last = static_cast<unsigned char>(chars[pos + 2]);
+            pos += 2;
+        }
+        for (auto c(first); c <= last; ++c) {
+            set.set(c);
+        }
+    }
+    if (ignore_case) {
+        fold(set);  // before negation, so "[!a]" does not match "A"
+    }
+    if (negate) {
+        set.flip();
+    }
+    return;
+}
+
+
+/// Parse a pattern into tokens.
+///
+/// @param pattern shell pattern
+/// @param ignore_case match letters regardless of case
+/// @param index pattern index
+/// @param tokens output tokens, terminated by an END token
+void parse(const string& pattern, bool ignore_case, int index, vector<Token>& tokens) {
+    const auto size(pattern.size());
+    for (size_t pos(0); pos < size; ++pos) {
+        const auto c(static_cast<unsigned char>(pattern[pos]));
+        Token token{Token::SET, bitset<256>(), index};
+        size_t end;
+        if (c == '*') {
+            if (not tokens.empty() and tokens.back().kind == Token::STAR) {
+                continue;  // consecutive stars are redundant
+            }
+            token.kind = Token::STAR;
+        }
+        else if (c == '?') {
+            token.set.set();
+        }
+        else if (c == '[' and (end = set_end(pattern, pos)) != string::npos) {
+            parse_set(pattern.substr(pos + 1, end - pos - 1), ignore_case, token.set);
+            pos = end;
+        }
+        else {
+            token.set.set(c);  // an unterminated '[' is a literal
+            if (ignore_case) {
+                fold(token.set);
+            }
+        }
+        tokens.emplace_back(token);
+    }
+    tokens.push_back({Token::END, bitset<256>(), index});
+    return;
+}
+
+
+/// Get a cached compiled pattern.
+///
+/// @param pattern shell pattern
+/// @param ignore_case match letters regardless of case
+/// @return compiled pattern
+const Pattern& cached(const string& pattern, bool ignore_case) {
+    thread_local unordered_map<string, Pattern> patterns;
+    const auto key((ignore_case ? 'i' : 'c') + pattern);
+    auto iter(patterns.find(key));
+    if (iter == patterns.end()) {
+        if (patterns.size() >= cache_size) {
+            patterns.clear();
+        }
+        iter = patterns.emplace(key, Pattern(pattern, ignore_case)).first;
+    }
+    return iter->second;
+}
+
+}  // internal linkage
+
+
+/// Nondeterministic automaton for a set of patterns.
+///
+/// A state is a sorted list of token positions. A STAR position matches any
+/// byte and stays in place, and it always includes the following position so
+/// that it can also match nothing.
+///
+class Pattern::Nfa {
+public:
+    vector<Token> tokens;
+    vector<uint32_t> starts;  // first position of each pattern
+
+    /// Get the initial state.
+    ///
+    /// @return initial positions
+    vector<uint32_t> start() const {
+        auto positions(starts);
+        close(positions);
+        return positions;
+    }
+
+    /// Advance a state by one byte.
+    ///
+    /// @param positions current positions
+    /// @param c input byte
+    /// @return next positions
+    vector<uint32_t> step(const vector<uint32_t>& positions, unsigned char c) const {
+        vector<uint32_t> next;
+        for (const auto pos: positions) {
+            const auto& token(tokens[pos]);
+            if (token.kind == Token::STAR) {
+                next.emplace_back(pos);
+            }
+            else if (token.kind == Token::SET and token.set[c]) {
+                next.emplace_back(pos + 1);
+            }
+        }
+        close(next);
+        return next;
+    }
+
+    /// Get the first pattern accepted by a state.
+    ///
+    /// @param positions current positions
+    /// @return pattern index, or -1 if no pattern is accepted
+    int accept(const vector<uint32_t>& positions) const {
+        // Patterns are stored in order, so the first END is the first pattern.
+        for (const auto pos: positions) {
+            if (tokens[pos].kind == Token::END) {
+                return tokens[pos].pattern;
+            }
+        }
+        return -1;
+    }
+
+    /// Match a name by simulating the automaton.
+    ///
+    /// @param name name to match
+    /// @return index of the first matching pattern, or -1
+    int find(StringView name) const {
+        auto positions(start());
+        for (const auto c: name) {
+            positions = step(positions, static_cast<unsigned char>(c));
+            if (positions.empty()) {
+                return -1;
+            }
+        }
+        return accept(positions);
+    }
+
+private:
+    /// Add the positions following STAR tokens to a state.
+    ///
+    /// @param positions positions to update
+    void close(vector<uint32_t>& positions) const {
+        // Consecutive stars are collapsed, so one pass is enough.
+        const auto count(positions.size());
+        for (size_t i(0); i < count; ++i) {
+            if (tokens[positions[i]].kind == Token::STAR) {
+                positions.emplace_back(positions[i] + 1);
+            }
+        }
+        std::sort(positions.begin(), positions.end());
+        positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+        return;
+    }
+};
+
+
+Pattern::Pattern(const string& pattern, bool ignore_case) {
+    compile({pattern}, ignore_case);
+}
+
+
+Pattern::Pattern(const vector<string>& patterns, bool ignore_case) {
+    compile(patterns, ignore_case);
+}
+
+
+Pattern::Pattern(std::initializer_list<string> patterns, bool ignore_case) {
+    compile(vector<string>(patterns), ignore_case);
+}
+
+
+int Pattern::find(StringView name) const {
+    if (table_.empty()) {
+        return nfa_->find(name);
+    }
+    auto state(start_);
+    for (const auto c: name) {
+        state = table_[state * class_count_ + classes_[static_cast<unsigned char>(c)]];
+        if (state == 0) {
+            return -1;  // no pattern can match
+        }
+    }
+    return accept_[state];
+}
+
+
+size_t Pattern::size() const {
+    return nfa_->starts.size();
+}
+
+
+void Pattern::compile(const vector<string>& patterns, bool ignore_case) {
+    const auto nfa(std::make_shared<Nfa>());
+    for (size_t index(0); index < patterns.size(); ++index) {
+        nfa->starts.emplace_back(nfa->tokens.size());
+        parse(patterns[index], ignore_case, static_cast<int>(index), nfa->tokens);
+    }
+    nfa_ = nfa;
+
+    // Bytes that are treated the same by every token are in the same class,
+    // so the transition table only needs one column per class. Each set
+    // splits the existing classes into members and non-members.
+    classes_.fill(0);
+    class_count_ = 1;
+    for (const auto& token: nfa->tokens) {
+        if (token.kind != Token::SET or class_count_ == 256) {
+            continue;
+        }
+        vector<int> split(class_count_ * 2, -1);
+        size_t count(0);
+        for (unsigned c(0); c < 256; ++c) {
+            auto& id(split[classes_[c] * 2 + token.set[c]]);
+            if (id < 0) {
+                id = static_cast<int>(count++);
+            }
+            classes_[c] = static_cast<std::uint8_t>(id);
+        }
+        class_count_ = count;
+    }
+    vector<unsigned char> members(class_count_);  // one byte from each class
+    for (unsigned c(256); c > 0; --c) {
+        members[classes_[c - 1]] = static_cast<unsigned char>(c - 1);
+    }
+
+    // Build the deterministic automaton by subset construction. State 0 is
+    // the empty set, which never matches.
+    map<vector<uint32_t>, uint32_t> ids;
+    vector<vector<uint32_t>> states;
+    const auto add = [&ids, &states](vector<uint32_t> positions) -> uint32_t {
+        const auto iter(ids.find(positions));
+        if (iter != ids.end()) {
+            return iter->second;
+        }
+        const auto id(static_cast<uint32_t>(states.size()));
+        ids.emplace(positions, id);
+        states.emplace_back(move(positions));
+        return id;
+    };
+    add(vector<uint32_t>());
+    start_ = add(nfa->start());
+    for (size_t state(0); state < states.size(); ++state) {
+        if (states.size() > max_states) {
+            table_.clear();
+            accept_.clear();
+            start_ = 0;
+            return;
+        }
+        const auto positions(states[state]);  // add() may reallocate
+        accept_.emplace_back(nfa->accept(positions));
+        for (const auto c: members) {
+            table_.emplace_back(add(nfa->step(positions, c)));
+        }
+    }
+    return;
+}
+
+
+bool fnmatch::fnmatch(StringView name, const string& pattern) {
+#if defined(_WIN32)
+    return cached(pattern, true).match(name);
+#else
+    return cached(pattern, false).match(name);
+#endif
+}
+
+
+bool fnmatch::fnmatchcase(StringView name, const string& pattern) {
+    return cached(pattern, false).match(name);
+}
+
+
+vector<string> fnmatch::filter(const vector<string>& names, const string& pattern) {
+    return filter(names.begin(), names.end(), pattern);
+}
+
+
+string fnmatch::translate(const string& pattern) {
+    // Bytes are written as hex escapes so that nothing needs to be quoted.
+    // Ranges are split at 0x80 because std::regex compares signed chars.
+    static const char digits[] = "0123456789abcdef";
+    const auto hex = [](unsigned c) {
+        return string{'\\', 'x', digits[c / 16], digits[c % 16]};
+    };
+    vector<Token> tokens;
+    parse(pattern, false, 0, tokens);
+    string regex;
+    for (const auto& token: tokens) {
+        if (token.kind == Token::STAR) {
+            regex += "[\\s\\S]*";
+        }
+        else if (token.kind == Token::END) {
+            break;
+        }
+        else if (token.set.all()) {
+            regex += "[\\s\\S]";
+        }
+        else if (token.set.none()) {
+            regex += "(?!)";
+        }
+        else if (token.set.count() == 1) {
+            unsigned c(0);
+            while (not token.set[c]) {
+                ++c;
+            }
+            regex += c < 0x80 and std::isalnum(c) ? string(1, static_cast<char>(c)) : hex(c);
+        }
+        else {
+            regex += '[';
+            for (unsigned c(0); c < 256; ++c) {
+                if (not token.set[c]) {
+                    continue;
+                }
+                auto last(c);
+                while (last + 1 < 256 and last + 1 != 0x80 and token.set[last + 1]) {
+                    ++last;
+                }
+                regex += last == c ? hex(c) : hex(c) + '-' + hex(last);
+                c = last;
+            }
+            regex += ']';
+        }
+    }
+    return regex;
+}
@@ -1,10 +1,10 @@
 /**
  * System-independent components of the 'path' module.
  */
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
-#include <deque>
-#include <regex>
+#include <cstring>
 #include <stdexcept>
 #include <tuple>
 #include <utility>
@@ -17,11 +17,8 @@ using pypp::os::getcwd;
 using pypp::str::endswith;
 using pypp::str::rstrip;
 using pypp::str::startswith;
-using std::deque;
 using std::invalid_argument;
 using std::pair;
-using std::regex;
-using std::regex_match;
 using std::string;
 using std::vector;
 
@@ -113,44 +110,157 @@ pair<string, string> split(const string& path, char sep) {
 
 
 /**
- * Normalize a path.
+ * Normalize a path in place.
  *
- * @param path: input path
+ * This is a single pass over the path with no memory allocation. The result
+ * is never longer than the input, so it is written over the input as each
+ * component is processed. A component is removed by a parent reference by
+ * truncating the output to the previous separator. Parent references that
+ * go above the root of an absolute path are dropped.
+ *
+ * @param first: first position of the path
+ * @param last: last position of the path (exclusive)
  * @param sep: path separator
- * @return normalized path
+ * @return: end of the normalized path, which is empty for the current
+ *     directory
  */
-string normpath(const std::string& path, char sep) {
-    static const string current{"."};
-    static const string parent{".."};
+char* normalize(char* first, char* last, char sep) {
+    // Relative parent references are retained unless the path is absolute
+    // on this platform. The `level` counter tracks the net depth of the
+    // path, and a parent reference only removes a component when the depth
+    // is positive.
+    const auto absolute(first != last and *first == path::SEP);
     ssize_t level{0};
-    deque<string> parts;
-    for (const auto& item: str::split(path, string(1, sep))) {
-        // Process each part of the path.
-        if (item.empty() or item == current) {
+    auto out(first);
+    if (first != last and *first == sep) {
+        ++out;  // leading separator is already in place
+    }
+    const auto root(out);
+    for (auto pos(first); pos != last; ) {
+        if (*pos == sep) {
+            ++pos;
+            continue;
+        }
+        const auto end(std::find(pos, last, sep));
+        const auto size(end - pos);
+        if (size == 1 and *pos == '.') {
+            pos = end;
             continue;
         }
-        if (item == parent) {
+        if (size == 2 and pos[0] == '.' and pos[1] == '.') {
             --level;
             if (level >= 0) {
-                parts.pop_back();
+                // Remove the last component.
+                while (out != root and *--out != sep) {}
+                pos = end;
+                continue;
             }
-            else if (not path::isabs(path)) {
-                parts.push_back(parent);
+            if (absolute) {
+                pos = end;
+                continue;
             }
         }
         else {
             ++level;
-            parts.push_back(item);
         }
+        if (out != root) {
+            *out++ = sep;
+        }
+        std::memmove(out, pos, size);  // ranges may overlap
+        out += size;
+        pos = end;
     }
-    string normed(join({parts.cbegin(), parts.cend()}, sep));
-    if (isabs(path, sep)) {
-        normed.insert(0, 1, sep);
+    return out;
+}
+
+
+/**
+ * Normalize a path.
+ *
+ * @param path: input path
+ * @param sep: path separator
+ * @return normalized path
+ */
+string normpath(string path, char sep) {
+    const auto first(&path[0]);
+    path.resize(normalize(first, first + path.size(), sep) - first);
+    if (path.empty()) {
+        path = ".";
     }
-    else if (normed.empty()) {
-        normed = current;
+    return path;
+}
+
+
+/**
+ * Normalize a path in place for use as a path object.
+ *
+ * A leading separator is skipped while normalizing, so any remaining
+ * separators are treated as part of a relative path.
+ *
+ * @param path: path to normalize
+ * @param sep: path separator
+ */
+void normalize_path(string& path, char sep) {
+    const auto first(&path[0]);
+    const auto offset(isabs(path, sep) ? 1 : 0);
+    path.resize(normalize(first + offset, first + path.size(), sep) - first);
+    if (path.empty()) {
+        path = ".";
     }
-    return normed;
+    return;
+}
+
+
+/**
+ * Determine if a string is a valid path name.
+ *
+ * A name is not empty, does not start with `.`, and does not contain a path
+ * separator.
+ *
+ * @tparam SEP: path separator
+ * @param name: name to test
+ * @return: true for a valid name
+ */
+template <char SEP>
+bool valid_name(const string& name) {
+    return not name.empty() and name[0] != '.' and name.find(SEP) == string::npos;
+}
+
+
+/**
+ * Determine if a string is a valid path suffix.
+ *
+ * A suffix is empty, or it starts with a `.` followed by at least one other
+ * character, and it does not contain a path separator.
+ *
+ * @tparam SEP: path separator
+ * @param suffix: suffix to test
+ * @return: true for a valid suffix
+ */
+template <char SEP>
+bool valid_suffix(const string& suffix) {
+    if (suffix.empty()) {
+        return true;
+    }
+    return suffix.size() > 1 and suffix[0] == '.' and suffix.find(SEP) == string::npos;
+}
+
+
+/**
+ * Determine if a path contains a parent reference (`..`).
+ *
+ * @param path: input path
+ * @param sep: path separator
+ * @return: true if any component is a parent reference
+ */
+bool has_parent(const string& path, char sep) {
+    for (auto pos(path.find("..")); pos != string::npos; pos = path.find("..", pos + 1)) {
+        const auto end(pos + 2);
+        if ((pos == 0 or path[pos - 1] == sep) and (end == path.size() or path[end] == sep)) {
+            return true;
+        }
+    }
+    return false;
 }
 
 }  // internal linkage
@@ -185,7 +295,11 @@ string path::abspath(const string& path) {
     if (isabs(path)) {
         return normpath(path);
     }
-    return normpath(join({getcwd(), path}));
+    auto joined(getcwd());
+    if (not endswith(joined, SEP)) {
+        joined += SEP;
+    }
+    return ::normpath(joined + path, SEP);
 }
 
 
@@ -209,40 +323,153 @@ pair<string, string> path::splitext(const string& path) {
 }
 
 
+path::Ancestors::Ancestors(str::StringView path, char sep):
+    sep_(sep),
+    value_(path) {
+    next();
+}
+
+
+bool path::Ancestors::active() const {
+    return active_;
+}
+
+
+str::StringView path::Ancestors::value() const {
+    return value_;
+}
+
+
+void path::Ancestors::next() {
+    // Each ancestor is found by scanning backwards from the end of the
+    // previous one, so generating all ancestors is linear in the path length.
+    const auto data(value_.data());
+    auto end(value_.size());
+    while (end > 0 and data[end - 1] == sep_) {
+        --end;
+    }
+    if (end == 0 or (end == 1 and data[0] == '.')) {
+        // This is a root, which has no parent.
+        active_ = false;
+        return;
+    }
+    auto pos(end);
+    while (pos > 0 and data[pos - 1] != sep_) {
+        --pos;
+    }
+    if (pos == 0) {
+        value_ = ".";
+        return;
+    }
+    auto last(pos);
+    while (last > 0 and data[last - 1] == sep_) {
+        --last;
+    }
+    // Keep all separators for a root.
+    value_ = str::StringView(data, last > 0 ? last : pos);
+    return;
+}
+
+
 template <char SEP>
 PureBasePath<SEP>::PureBasePath(string path) {
-    static const string pathsep(1, sep);
-    if (::isabs(path, sep)) {
-        parts_.emplace_back(pathsep);
-        path.erase(path.begin());
-    }
-    const auto parts(str::split(::normpath(path, sep), pathsep));
-    if (parts.size() > 1 or parts.front() != ".") {
-        copy(begin(parts), end(parts), back_inserter(parts_));
+    normalize_path(path, sep);
+    path_ = std::move(path);
+}
+
+
+template <char SEP>
+PureBasePath<SEP>::PureBasePath(const PureBasePath& other):
+    path_(other.path_),
+    hash_(other.hash_.load(std::memory_order_relaxed)) {}
+
+
+template <char SEP>
+PureBasePath<SEP>::PureBasePath(PureBasePath&& other) noexcept:
+    path_(std::move(other.path_)),
+    hash_(other.hash_.exchange(0, std::memory_order_relaxed)) {}
+
+
+template <char SEP>
+PureBasePath<SEP>& PureBasePath<SEP>::operator=(const PureBasePath& other) {
+    path_ = other.path_;
+    hash_.store(other.hash_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return *this;
+}
+
+
+template <char SEP>
+PureBasePath<SEP>& PureBasePath<SEP>::operator=(PureBasePath&& other) noexcept {
+    path_ = std::move(other.path_);
+    hash_.store(other.hash_.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+    return *this;
+}
+
+
+template <char SEP>
+size_t PureBasePath<SEP>::hash() const {
+    // The cache is atomic so that concurrent calls on the same path are safe,
+    // e.g. for a path shared by multiple threads. Each thread computes the
+    // same value, so relaxed ordering is sufficient.
+    auto value(hash_.load(std::memory_order_relaxed));
+    if (value == 0) {
+        value = std::hash<string>()(path_);
+        if (value == 0) {
+            value = 1;  // zero is reserved for an uncomputed value
+        }
+        hash_.store(value, std::memory_order_relaxed);
     }
+    return value;
 }
 
 
 template <char SEP>
 PureBasePath<SEP>::operator std::string() const {
-    auto result(parts_.empty() ? "." : str::join(parts_, sep));
-    if (is_absolute() and parts_.size() > 1) {
-        // Fix the double slash at the beginning.
-        result.erase(result.begin());
+    return path_;
+}
+
+
+template <char SEP>
+vector<string> PureBasePath<SEP>::parts() const {
+    vector<string> parts;
+    if (path_ == ".") {
+        return parts;
+    }
+    string::size_type pos(0);
+    if (is_absolute()) {
+        parts.emplace_back(1, SEP);
+        if (path_.size() == 1) {
+            return parts;
+        }
+        ++pos;
+    }
+    while (true) {
+        const auto end(path_.find(SEP, pos));
+        parts.emplace_back(path_, pos, end - pos);
+        if (end == string::npos) {
+            break;
+        }
+        pos = end + 1;
     }
-    return result;
+    return parts;
+}
+
+
+template <char SEP>
+path::Ancestors PureBasePath<SEP>::ancestors() const {
+    return Ancestors(path_, SEP);
 }
 
 
 template <char SEP>
 bool PureBasePath<SEP>::is_absolute() const {
-    return not parts_.empty() and ::isabs(parts_.front(), sep);
+    return ::isabs(path_, sep);
 }
 
 
 template <char SEP>
 string PureBasePath<SEP>::name() const {
-    return is_root() ? "" : parts_.back();
+    return is_root() ? "" : path_.substr(name_pos());
 }
 
 
@@ -254,7 +481,90 @@ string PureBasePath<SEP>::root() const {
 
 template <char SEP>
 bool PureBasePath<SEP>::is_root() const {
-    return parts_.empty() or (parts_.size() == 1 and is_absolute());
+    return path_ == "." or (path_.size() == 1 and is_absolute());
+}
+
+
+template <char SEP>
+string::size_type PureBasePath<SEP>::name_pos() const {
+    const auto pos(path_.rfind(sep));
+    return pos == string::npos ? 0 : pos + 1;
+}
+
+
+template <char SEP>
+void PureBasePath<SEP>::pop_name() {
+    const Ancestors ancestors(path_, SEP);
+    if (not ancestors.active()) {
+        return;  // root
+    }
+    const auto parent(ancestors.value());
+    if (parent.data() == path_.data()) {
+        path_.resize(parent.size());
+    }
+    else {
+        path_ = ".";
+    }
+    hash_.store(0, std::memory_order_relaxed);
+    return;
+}
+
+
+template <char SEP>
+void PureBasePath<SEP>::append(const string& other) {
+    hash_.store(0, std::memory_order_relaxed);
+    if (::isabs(other, sep)) {
+        // An absolute path replaces this one.
+        path_ = other;
+        normalize_path(path_, sep);
+        return;
+    }
+    if (has_parent(other, sep)) {
+        // A parent reference may remove existing components, so normalize
+        // the entire joined path. The existing path is normalized, so it only
+        // ends with a separator if it is a root.
+        if (not endswith(path_, sep)) {
+            path_ += sep;
+        }
+        path_ += other;
+        normalize_path(path_, sep);
+        return;
+    }
+    // The existing path is already normalized, so the components of the other
+    // path can be appended directly.
+    if (path_ == ".") {
+        path_.clear();
+    }
+    string::size_type pos(0);
+    while (pos < other.size()) {
+        auto end(other.find(sep, pos));
+        if (end == string::npos) {
+            end = other.size();
+        }
+        if (end > pos and not (end - pos == 1 and other[pos] == '.')) {
+            if (not path_.empty() and path_.back() != sep) {
+                path_ += sep;
+            }
+            path_.append(other, pos, end - pos);
+        }
+        pos = end + 1;
+    }
+    if (path_.empty()) {
+        path_ = ".";
+    }
+    return;
+}
+
+
+template <char SEP>
+void PureBasePath<SEP>::set_parts(vector<string>::const_iterator first, vector<string>::const_iterator last) {
+    path_ = first == last ? "." : str::join(vector<string>(first, last), sep);
+    if (last - first > 1 and ::isabs(*first, sep)) {
+        // Fix the double separator after an absolute root.
+        path_.erase(path_.begin());
+    }
+    hash_.store(0, std::memory_order_relaxed);
+    return;
 }
 
 
@@ -267,7 +577,7 @@ string PureBasePath<SEP>::stem() const {
         // ignore a solitary ".".
         stem = "";
     }
-    else if (not parts_.empty() and endswith(parts_.back(), ".")) {
+    else if (not is_root() and endswith(path_, ".")) {
         stem += ".";
     }
     return stem;
@@ -304,51 +614,58 @@ vector<string> PureBasePath<SEP>::suffixes() const {
 
 template <char SEP>
 short PureBasePath<SEP>::compare(const PureBasePath& other) const {
-    const string lhs(*this);
-    const string rhs(other);
-    if (lhs == rhs) {
-        return 0;
+    const auto cmp(path_.compare(other.path_));
+    return cmp == 0 ? 0 : (cmp < 0 ? -1 : 1);
+}
+
+
+template <char SEP>
+bool PureBasePath<SEP>::equals(const PureBasePath& other) const {
+    // Hashes are only compared if both have been computed already; computing
+    // them here would be slower than comparing the strings.
+    const auto hash(hash_.load(std::memory_order_relaxed));
+    const auto other_hash(other.hash_.load(std::memory_order_relaxed));
+    if (hash != 0 and other_hash != 0 and hash != other_hash) {
+        return false;
     }
-    return lhs < rhs ? -1 : 1;
+    return path_ == other.path_;
 }
 
 
 template <char SEP>
 void PureBasePath<SEP>::set_name(const std::string& name) {
-    static const char esc{'\\'};
-    string sep_re(1, sep);
-    if (sep == esc) {
-        // This character must be escaped inside a regular expression.
-        sep_re = esc + sep_re;
-    }
-    const regex valid_name("^[^.][^" + sep_re + "]*$");
-    if (not regex_match(name, valid_name)) {
+    if (not valid_name<SEP>(name)) {
         throw invalid_argument("invalid name '" + name + "'");
     }
-    if (this->name().empty()) {
+    const auto pos(name_pos());
+    if (is_root() or pos == path_.size()) {
         throw invalid_argument("path has an empty name");
     }
-    parts_.back() = name;
+    path_.replace(pos, string::npos, name);
+    hash_.store(0, std::memory_order_relaxed);
     return;
 }
 
 
 template <char SEP>
 void PureBasePath<SEP>::set_suffix(const string& suffix) {
-    static const char esc{'\\'};
-    string sep_re(1, sep);
-    if (sep == esc) {
-        // This character must be escaped inside a regular expression.
-        sep_re = esc + sep_re;
-    }
-    const regex valid_suffix("^\\.[^" + sep_re + "]+$");
-    if (not (suffix.empty() or regex_match(suffix, valid_suffix))) {
+    if (not valid_suffix<SEP>(suffix)) {
         throw invalid_argument("invalid suffix '" + suffix + "'");
     }
-    if (this->name().empty()) {
+    const auto pos(name_pos());
+    if (is_root() or pos == path_.size()) {
         throw invalid_argument("path has an empty name");
     }
-    set_name(stem() + suffix);
+    if (path_[pos] == '.') {
+        // The new name would be hidden, which is not a valid name.
+        throw invalid_argument("invalid name '" + stem() + suffix + "'");
+    }
+    // Replace everything after the stem, which is the entire name if it has
+    // no suffix (see stem()).
+    const auto dot(path_.rfind('.'));
+    const auto end(dot != string::npos and dot > pos and dot != path_.size() - 1 ? dot : path_.size());
+    path_.replace(end, string::npos, suffix);
+    hash_.store(0, std::memory_order_relaxed);
     return;
 }
 
@@ -357,13 +674,14 @@ PurePosixPath::PurePosixPath(string path): PureBasePath(move(path)) {}
 
 
 PurePosixPath PurePosixPath::joinpath(const PurePosixPath& other) const {
-    return joinpath(string(other));
+    return joinpath(other.path_);
 }
 
 
 PurePosixPath PurePosixPath::joinpath(const string& other) const {
-    const vector<string> parts({string(*this), other});
-    return PurePosixPath(::join(parts, sep));
+    PurePosixPath path(*this);
+    path.append(other);
+    return path;
 }
 
 
@@ -380,19 +698,19 @@ PurePosixPath PurePosixPath::operator/(const PurePosixPath& other) const {
 
 
 PurePosixPath& PurePosixPath::operator/=(const string& path) {
-    *this = joinpath(path);
+    append(path);
     return *this;
 }
 
 
 PurePosixPath& PurePosixPath::operator/=(const PurePosixPath& other) {
-    *this = joinpath(other);
+    append(other.path_);
     return *this;
 }
 
 
 bool PurePosixPath::operator==(const PurePosixPath& other) const {
-    return compare(other) == 0;
+    return equals(other);
 }
 
 
@@ -408,20 +726,15 @@ bool PurePosixPath::operator<(const PurePosixPath& other) const {
 
 PurePosixPath PurePosixPath::parent() const {
     PurePosixPath path(*this);
-    const string str(path);
-    if (not is_root()) {
-        path.parts_.pop_back();
-    }
+    path.pop_name();
     return path;
 }
 
 
 vector<PurePosixPath> PurePosixPath::parents() const {
     vector<PurePosixPath> paths;
-    PurePosixPath path(*this);
-    while (not path.is_root()) {
-        path = path.parent();
-        paths.emplace_back(path);
+    for (const auto path: ancestors()) {
+        paths.emplace_back(string(path));
     }
     return paths;
 }
@@ -429,15 +742,17 @@ vector<PurePosixPath> PurePosixPath::parents() const {
 
 PurePosixPath PurePosixPath::relative_to(const PurePosixPath& other) const {
     const string error("path does not start with '" + string(other) + "'");
-    if (parts_.size() < other.parts_.size()) {
+    const auto parts(this->parts());
+    const auto other_parts(other.parts());
+    if (parts.size() < other_parts.size()) {
         throw invalid_argument(error);
     }
-    const auto diff(mismatch(other.parts_.begin(), other.parts_.end(), parts_.begin()));
-    if (diff.first != other.parts_.end() and not other.parts_.empty()) {
+    const auto diff(mismatch(other_parts.begin(), other_parts.end(), parts.begin()));
+    if (diff.first != other_parts.end() and not other_parts.empty()) {
         throw invalid_argument(error);
     }
     PurePosixPath path;
-    path.parts_ = {diff.second, parts_.end()};
+    path.set_parts(diff.second, parts.end());
     return path;
 }
 
@@ -460,12 +775,14 @@ PureWindowsPath::PureWindowsPath(string path): PureBasePath(move(path)) {}
 
 
 PureWindowsPath PureWindowsPath::joinpath(const PureWindowsPath& other) const {
-    return joinpath(string(other));
+    return joinpath(other.path_);
 }
 
 
 PureWindowsPath PureWindowsPath::joinpath(const string& other) const {
-    return PureWindowsPath(::join({string(*this), other}, sep));
+    PureWindowsPath path(*this);
+    path.append(other);
+    return path;
 }
 
 
@@ -482,19 +799,19 @@ PureWindowsPath PureWindowsPath::operator/(const PureWindowsPath& other) const {
 
 
 PureWindowsPath& PureWindowsPath::operator/=(const string& path) {
-    *this = joinpath(path);
+    append(path);
     return *this;
 }
 
 
 PureWindowsPath& PureWindowsPath::operator/=(const PureWindowsPath& other) {
-    *this = joinpath(other);
+    append(other.path_);
     return *this;
 }
 
 
 bool PureWindowsPath::operator==(const PureWindowsPath& other) const {
-    return compare(other) == 0;
+    return equals(other);
 }
 
 
@@ -510,20 +827,15 @@ bool PureWindowsPath::operator<(const PureWindowsPath& other) const {
 
 PureWindowsPath PureWindowsPath::parent() const {
     PureWindowsPath path(*this);
-    const string str(path);
-    if (not is_root()) {
-        path.parts_.pop_back();
-    }
+    path.pop_name();
     return path;
 }
 
 
 vector<PureWindowsPath> PureWindowsPath::parents() const {
     vector<PureWindowsPath> paths;
-    PureWindowsPath path(*this);
-    while (not path.is_root()) {
-        path = path.parent();
-        paths.emplace_back(path);
+    for (const auto path: ancestors()) {
+        paths.emplace_back(string(path));
     }
     return paths;
 }
@@ -531,15 +843,17 @@ vector<PureWindowsPath> PureWindowsPath::parents() const {
 
 PureWindowsPath PureWindowsPath::relative_to(const PureWindowsPath& other) const {
     const string error{"path does not start with '" + string(other) + "'"};
-    if (parts_.size() < other.parts_.size()) {
+    const auto parts(this->parts());
+    const auto other_parts(other.parts());
+    if (parts.size() < other_parts.size()) {
         throw invalid_argument(error);
     }
-    const auto diff(mismatch(other.parts_.begin(), other.parts_.end(), parts_.begin()));
-    if (diff.first != other.parts_.end() and not other.parts_.empty()) {
+    const auto diff(mismatch(other_parts.begin(), other_parts.end(), parts.begin()));
+    if (diff.first != other_parts.end() and not other_parts.empty()) {
         throw invalid_argument(error);
     }
     PureWindowsPath path;
-    path.parts_ = {diff.second, parts_.end()};
+    path.set_parts(diff.second, parts.end());
     return path;
 }
 
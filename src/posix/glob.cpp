@@ -0,0 +1,311 @@
+/// POSIX implementation of the 'glob' module.
+///
+#include "sys/stat.h"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include "pypp/fnmatch.hpp"
+#include "pypp/glob.hpp"
+#include "pypp/os.hpp"
+#include "pypp/path.hpp"
+#include "../threadpool.hpp"
+
+
+using std::move;
+using std::runtime_error;
+using std::size_t;
+using std::string;
+using std::vector;
+
+using namespace pypp;
+using glob::GlobIterator;
+
+
+namespace {
+
+/// Join a directory path and an entry name.
+///
+/// Unlike path::join(), an empty directory is the current directory.
+///
+/// @param dir directory path
+/// @param name entry name
+/// @return joined path
+string join_name(const string& dir, const string& name) {
+    if (dir.empty()) {
+        return name;
+    }
+    return dir.back() == '/' ? dir + name : dir + '/' + name;
+}
+
+
+/// Determine if a path exists without following symbolic links.
+///
+/// @param path file path
+/// @return true if the path exists
+bool lexists(const string& path) {
+    struct stat status;
+    return lstat(path.c_str(), &status) == 0;
+}
+
+}  // internal linkage
+
+
+/// Pattern compiled into path segments.
+///
+/// Consecutive literal segments are merged so that they are resolved with a
+/// single system call.
+///
+class glob::Pattern {
+public:
+    enum Kind { LITERAL, WILDCARD, RECURSIVE };
+
+    struct Segment {
+        Kind kind;
+        string text;
+        std::shared_ptr<const fnmatch::Pattern> matcher;  // WILDCARD only
+        bool hidden;  // matches names that start with a dot
+    };
+
+    string root;  // "/" for an absolute pattern
+    vector<Segment> segments;
+    bool dironly;  // only match directories
+    bool recursive{false};  // has a recursive segment
+
+    /// Compile a pattern.
+    ///
+    /// @param pattern path pattern
+    /// @param recursive `**` matches any number of directories
+    Pattern(const string& pattern, bool recursive) {
+        root = not pattern.empty() and pattern[0] == '/' ? "/" : "";
+        dironly = pattern.size() > 1 and pattern.back() == '/';
+        size_t pos(0);
+        while (pos < pattern.size()) {
+            auto end(pattern.find('/', pos));
+            if (end == string::npos) {
+                end = pattern.size();
+            }
+            const auto part(pattern.substr(pos, end - pos));
+            pos = end + 1;
+            if (part.empty()) {
+                continue;
+            }
+            if (recursive and part == "**") {
+                if (segments.empty() or segments.back().kind != RECURSIVE) {
+                    segments.push_back({RECURSIVE, part, nullptr, false});
+                    this->recursive = true;
+                }
+            }
+            else if (not has_magic(part)) {
+                if (not segments.empty() and segments.back().kind == LITERAL) {
+                    segments.back().text += '/' + part;
+                }
+                else {
+                    segments.push_back({LITERAL, part, nullptr, true});
+                }
+            }
+            else {
+                const auto matcher(std::make_shared<const fnmatch::Pattern>(part));
+                segments.push_back({WILDCARD, part, matcher, part[0] == '.'});
+            }
+        }
+    }
+
+    /// Expand one step of the pattern.
+    ///
+    /// A state is an existing directory and the index of the next segment to
+    /// match in it. Each state requires at most one directory read, so states
+    /// can be expanded in any order, or in parallel.
+    ///
+    /// @tparam Emit callable taking a matching path
+    /// @tparam Push callable taking a new state
+    /// @param dir directory path, or empty for the current directory
+    /// @param index segment index
+    /// @param emit match handler
+    /// @param push new state handler
+    template <typename Emit, typename Push>
+    void expand(const string& dir, size_t index, Emit emit, Push push) const {
+        if (index == segments.size()) {
+            // This only happens for a pattern without any segments, e.g. "/".
+            if (not dir.empty()) {
+                emit(dir);
+            }
+            return;
+        }
+        const auto& segment(segments[index]);
+        const auto last(index + 1 == segments.size());
+        const string suffix(dironly ? "/" : "");
+        if (segment.kind == LITERAL) {
+            const auto path(join_name(dir, segment.text));
+            if (last) {
+                if (dironly ? path::isdir(path) : lexists(path)) {
+                    emit(path + suffix);
+                }
+            }
+            else if (path::isdir(path)) {
+                push(path, index + 1);
+            }
+            return;
+        }
+        // A wildcard following a recursive segment is matched with the same
+        // directory read instead of a separate state for zero directories.
+        const auto fused(segment.kind == RECURSIVE and not last and segments[index + 1].kind == WILDCARD);
+        if (segment.kind == RECURSIVE and not last and not fused) {
+            push(dir, index + 1);  // zero directories
+        }
+        const auto match = [&](const os::DirEntry& entry, size_t next) {
+            const auto& wildcard(segments[next]);
+            const auto& name(entry.name());
+            if ((name[0] == '.' and not wildcard.hidden) or not wildcard.matcher->match(name)) {
+                return;
+            }
+            if (next + 1 < segments.size()) {
+                if (entry.is_dir()) {
+                    push(join_name(dir, name), next + 1);
+                }
+            }
+            else if (not dironly or entry.is_dir()) {
+                emit(join_name(dir, name) + suffix);
+            }
+        };
+        try {
+            for (const auto& entry: os::scandir(dir.empty() ? "." : dir)) {
+                if (segment.kind == WILDCARD) {
+                    match(entry, index);
+                    continue;
+                }
+                if (fused) {
+                    match(entry, index + 1);
+                }
+                const auto& name(entry.name());
+                if (name[0] == '.') {
+                    continue;
+                }
+                // Symbolic links are not followed to avoid cycles.
+                const auto child(join_name(dir, name));
+                const auto is_dir(entry.is_dir(false));
+                if (last and (not dironly or is_dir)) {
+                    emit(child + suffix);
+                }
+                if (is_dir) {
+                    push(child, index);
+                }
+            }
+        }
+        catch (const runtime_error&) {
+            // As in Python, directories that cannot be read are ignored.
+        }
+        return;
+    }
+};
+
+
+GlobIterator::GlobIterator(const string& pattern, bool recursive):
+    pattern_(std::make_shared<Pattern>(pattern, recursive)) {
+    if (not pattern.empty()) {
+        pending_.emplace_back(pattern_->root, 0);
+    }
+    next();
+}
+
+
+bool GlobIterator::active() const {
+    return active_;
+}
+
+
+string GlobIterator::value() const {
+    return value_;
+}
+
+
+void GlobIterator::next() {
+    // Directories are visited depth-first, and each directory is read once.
+    // The results of a read are reversed so that they are generated in
+    // directory order.
+    while (matches_.empty() and not pending_.empty()) {
+        const auto state(move(pending_.back()));
+        pending_.pop_back();
+        const auto count(pending_.size());
+        pattern_->expand(state.first, state.second,
+            [this](const string& path) { matches_.emplace_back(path); },
+            [this](const string& path, size_t index) { pending_.emplace_back(path, index); });
+        std::reverse(pending_.begin() + count, pending_.end());
+        std::reverse(matches_.begin(), matches_.end());
+    }
+    if (matches_.empty()) {
+        active_ = false;
+        return;
+    }
+    value_ = move(matches_.back());
+    matches_.pop_back();
+    return;
+}
+
+
+GlobIterator glob::iglob(const string& pattern, bool recursive) {
+    return GlobIterator(pattern, recursive);
+}
+
+
+vector<string> glob::glob(const string& pattern, bool recursive, size_t threads) {
+    vector<string> matches;
+    const Pattern compiled(pattern, recursive);
+    if (pattern.empty()) {
+        return matches;
+    }
+    if (threads == 1 or not compiled.recursive) {
+        for (const auto& path: iglob(pattern, recursive)) {
+            matches.emplace_back(path);
+        }
+    }
+    else {
+        // Each state is a separate task, so directories at any depth are read
+        // in parallel.
+        threadpool::ThreadPool pool(threads);
+        std::mutex mutex;
+        std::function<void(const string&, size_t)> visit;
+        visit = [&](const string& dir, size_t index) {
+            vector<string> found;
+            compiled.expand(dir, index,
+                [&found](const string& path) { found.emplace_back(path); },
+                [&pool, &visit](const string& path, size_t index) {
+                    pool.submit([&visit, path, index]() { visit(path, index); });
+                });
+            if (not found.empty()) {
+                std::lock_guard<std::mutex> lock(mutex);
+                matches.insert(matches.end(), std::make_move_iterator(found.begin()),
+                               std::make_move_iterator(found.end()));
+            }
+        };
+        pool.submit([&visit, &compiled]() { visit(compiled.root, 0); });
+        pool.wait();
+    }
+    std::sort(matches.begin(), matches.end());
+    return matches;
+}
+
+
+string glob::escape(const string& path) {
+    string escaped;
+    escaped.reserve(path.size());
+    for (const auto c: path) {
+        if (c == '*' or c == '?' or c == '[') {
+            escaped += '[';
+            escaped += c;
+            escaped += ']';
+        }
+        else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+
+bool glob::has_magic(const string& pattern) {
+    return pattern.find_first_of("*?[") != string::npos;
+}
@@ -1,16 +1,29 @@
 /// POSIX implementation of the 'os' module.
 ///
 #include "dirent.h"
+#include "fcntl.h"
 #include "unistd.h"
 #include "sys/stat.h"
+#if defined(__linux__)
+#include "sys/syscall.h"
+#endif
+#include <algorithm>
 #include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <stdexcept>
-#include "pypp/func.hpp"
+#include <utility>
 #include "pypp/os.hpp"
 #include "pypp/path.hpp"
+#include "../threadpool.hpp"
+#include "uring.hpp"
 
 
+using std::find;
+using std::getenv;
+using std::memcpy;
 using std::runtime_error;
 using std::strerror;
 using std::string;
@@ -19,6 +32,419 @@ using std::vector;
 using namespace pypp;
 
 
+namespace {
+
+/// Size of the ScandirIterator buffer.
+///
+/// Each getdents64() call fills as much of the buffer as possible, so a larger
+/// buffer means fewer system calls for large directories.
+///
+const std::size_t scandir_buffer_size(64 * 1024);
+
+
+/// Number of paths handled by each stat_many() fallback task.
+///
+const std::size_t stat_block_size(256);
+
+
+#if defined(__linux__)
+/// Layout of the records returned by the getdents64() system call.
+///
+/// The name is a null-terminated string of variable length, and each record
+/// is padded to the next 8-byte boundary.
+///
+struct Dirent64 {
+    std::uint64_t d_ino;
+    std::int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+#endif
+
+
+/// Determine if a directory entry name is "." or "..".
+///
+/// @param name entry name
+/// @return true for a special entry
+bool is_special(const char* name) {
+    return name[0] == '.' and (name[1] == '\0' or (name[1] == '.' and name[2] == '\0'));
+}
+
+
+/// Join a directory path and an entry name.
+///
+/// This is the same as path::join() for two segments.
+///
+/// @param dir directory path
+/// @param name entry name
+/// @return joined path
+string join_name(const string& dir, const string& name) {
+    string path;
+    path.reserve(dir.size() + name.size() + 1);
+    path = dir;
+    if (not path.empty() and path.back() != '/') {
+        path += '/';
+    }
+    return path += name;
+}
+
+
+/// Read a directory for walk().
+///
+/// Entries are classified using the types reported by scandir(), so this
+/// only requires a stat() call for a symbolic link or if the type is unknown.
+///
+/// @param path directory path
+/// @param onerror error handler, or nullptr to ignore errors
+/// @param entry output directory contents
+/// @param links output names of subdirectories that are symbolic links
+/// @return true on success
+bool scan_dir(const string& path, const os::WalkError& onerror, os::WalkEntry& entry, vector<string>& links) {
+    entry.dirpath = path;
+    entry.dirnames.clear();
+    entry.filenames.clear();
+    links.clear();
+    try {
+        for (const auto& item: os::scandir(path)) {
+            if (item.is_dir()) {
+                entry.dirnames.emplace_back(item.name());
+                if (item.is_symlink()) {
+                    links.emplace_back(item.name());
+                }
+            }
+            else {
+                entry.filenames.emplace_back(item.name());
+            }
+        }
+    }
+    catch (const runtime_error& error) {
+        if (onerror) {
+            onerror(error);
+        }
+        return false;
+    }
+    return true;
+}
+
+
+/// Determine if walk() should visit a subdirectory.
+///
+/// @param name subdirectory name
+/// @param links names of subdirectories that are symbolic links
+/// @param followlinks walk into symbolic links
+/// @return true to visit the subdirectory
+bool descend(const string& name, const vector<string>& links, bool followlinks) {
+    return followlinks or find(links.begin(), links.end(), name) == links.end();
+}
+
+
+/// Convert a timestamp to nanoseconds.
+///
+/// @param time timestamp
+/// @return nanoseconds since the epoch
+std::int64_t nanoseconds(const struct timespec& time) {
+    return static_cast<std::int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+
+
+/// Create a directory.
+///
+/// It is not an error if the directory already exists, e.g. if it was created
+/// by another thread or process after checking for it.
+///
+/// @param path directory path
+/// @param mode directory permissions
+void make_dir(const string& path, mode_t mode) {
+    if (mkdir(path.c_str(), mode) != 0) {
+        if (not (errno == EEXIST or errno == EISDIR)) {
+            throw runtime_error(strerror(errno));
+        }
+    }
+    return;
+}
+
+}  // internal linkage
+
+
+os::stat_result::stat_result(const struct stat& status):
+    st_mode(status.st_mode),
+    st_ino(status.st_ino),
+    st_dev(status.st_dev),
+    st_nlink(status.st_nlink),
+    st_uid(status.st_uid),
+    st_gid(status.st_gid),
+    st_size(status.st_size) {
+#if defined(__APPLE__)
+    st_atime_ns = nanoseconds(status.st_atimespec);
+    st_mtime_ns = nanoseconds(status.st_mtimespec);
+    st_ctime_ns = nanoseconds(status.st_ctimespec);
+#else
+    st_atime_ns = nanoseconds(status.st_atim);
+    st_mtime_ns = nanoseconds(status.st_mtim);
+    st_ctime_ns = nanoseconds(status.st_ctim);
+#endif
+}
+
+
+os::stat_result os::stat(const string& path, bool follow_symlinks) {
+    struct stat status;
+    const auto result(follow_symlinks ? ::stat(path.c_str(), &status) : ::lstat(path.c_str(), &status));
+    if (result != 0) {
+        throw runtime_error(string(strerror(errno)) + ": " + path);
+    }
+    return stat_result(status);
+}
+
+
+os::stat_result os::lstat(const string& path) {
+    return stat(path, false);
+}
+
+
+vector<os::StatEntry> os::stat_many(const vector<string>& paths, bool follow_symlinks, size_t threads) {
+    vector<StatEntry> results(paths.size());
+    if (paths.empty()) {
+        return results;
+    }
+    if (not getenv("PYPP_DISABLE_IO_URING") and uring::stat_many(paths, follow_symlinks, results)) {
+        return results;
+    }
+    // Fall back to blocking calls, with a block of paths for each task.
+    threadpool::ThreadPool pool(threads);
+    for (size_t first(0); first < paths.size(); first += stat_block_size) {
+        const auto last(std::min(first + stat_block_size, paths.size()));
+        pool.submit([&paths, &results, first, last, follow_symlinks]() {
+            for (auto index(first); index < last; ++index) {
+                const auto path(paths[index].c_str());
+                struct stat status;
+                if ((follow_symlinks ? ::stat(path, &status) : ::lstat(path, &status)) == 0) {
+                    results[index].status = stat_result(status);
+                }
+                else {
+                    results[index].error = errno;
+                }
+            }
+        });
+    }
+    pool.wait();
+    return results;
+}
+
+
+os::DirEntry::DirEntry(const string& dir, const char* name, unsigned char type, ino_t inode):
+    name_(name),
+    type_(type),
+    inode_(inode) {
+    path_.reserve(dir.size() + name_.size() + 1);
+    path_ = dir;
+    if (not path_.empty() and path_.back() != '/') {
+        path_ += '/';
+    }
+    path_ += name_;
+}
+
+
+const string& os::DirEntry::name() const {
+    return name_;
+}
+
+
+const string& os::DirEntry::path() const {
+    return path_;
+}
+
+
+ino_t os::DirEntry::inode() const {
+    return inode_;
+}
+
+
+bool os::DirEntry::is_dir(bool follow_symlinks) const {
+    if (type_ != DT_UNKNOWN and not (follow_symlinks and type_ == DT_LNK)) {
+        return type_ == DT_DIR;
+    }
+    const auto status(this->status(follow_symlinks));
+    return status and S_ISDIR(status->st_mode);
+}
+
+
+bool os::DirEntry::is_file(bool follow_symlinks) const {
+    if (type_ != DT_UNKNOWN and not (follow_symlinks and type_ == DT_LNK)) {
+        return type_ == DT_REG;
+    }
+    const auto status(this->status(follow_symlinks));
+    return status and S_ISREG(status->st_mode);
+}
+
+
+bool os::DirEntry::is_symlink() const {
+    if (type_ != DT_UNKNOWN) {
+        return type_ == DT_LNK;
+    }
+    const auto status(this->status(false));
+    return status and S_ISLNK(status->st_mode);
+}
+
+
+const os::stat_result& os::DirEntry::stat(bool follow_symlinks) const {
+    const auto status(this->status(follow_symlinks));
+    if (not status) {
+        throw runtime_error(string(strerror(errno)) + ": " + path_);
+    }
+    return *status;
+}
+
+
+const os::stat_result* os::DirEntry::status(bool follow_symlinks) const {
+    struct stat status;
+    if (follow_symlinks and is_symlink()) {
+        if (not has_stat_) {
+            if (::stat(path_.c_str(), &status) != 0) {
+                return nullptr;
+            }
+            stat_ = stat_result(status);
+            has_stat_ = true;
+        }
+        return &stat_;
+    }
+    // For anything other than a symlink, stat() and lstat() are the same.
+    if (not has_lstat_) {
+        if (::lstat(path_.c_str(), &status) != 0) {
+            return nullptr;
+        }
+        lstat_ = stat_result(status);
+        has_lstat_ = true;
+    }
+    return &lstat_;
+}
+
+
+os::ScandirIterator::ScandirIterator(const string& path):
+    path_(path),
+    fd_(open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)) {
+    if (fd_ < 0) {
+        throw runtime_error(string(strerror(errno)) + ": " + path);
+    }
+    // The destructor will not run if the constructor throws, so the directory
+    // must be closed here.
+    try {
+#if defined(__linux__)
+        buffer_.resize(scandir_buffer_size);
+#else
+        // Use the portable interface, which also buffers entries internally.
+        dir_ = fdopendir(fd_);
+        if (not dir_) {
+            throw runtime_error(string(strerror(errno)) + ": " + path);
+        }
+#endif
+        next();
+    }
+    catch (...) {
+        if (dir_) {
+            closedir(dir_);  // also closes fd_
+        }
+        else {
+            close(fd_);
+        }
+        throw;
+    }
+}
+
+
+os::ScandirIterator::ScandirIterator(ScandirIterator&& other) noexcept:
+    path_(std::move(other.path_)),
+    fd_(other.fd_),
+    dir_(other.dir_),
+    buffer_(std::move(other.buffer_)),
+    pos_(other.pos_),
+    end_(other.end_),
+    entry_(std::move(other.entry_)),
+    active_(other.active_) {
+    other.fd_ = -1;
+    other.dir_ = nullptr;
+    other.active_ = false;
+}
+
+
+os::ScandirIterator::~ScandirIterator() {
+    if (dir_) {
+        closedir(dir_);  // also closes fd_
+    }
+    else if (fd_ >= 0) {
+        close(fd_);
+    }
+}
+
+
+bool os::ScandirIterator::active() const {
+    return active_;
+}
+
+
+os::DirEntry os::ScandirIterator::value() const {
+    return entry_;
+}
+
+
+void os::ScandirIterator::next() {
+    active_ = read();
+    return;
+}
+
+
+bool os::ScandirIterator::read() {
+#if defined(__linux__)
+    while (true) {
+        if (pos_ == end_) {
+            const auto count(syscall(SYS_getdents64, fd_, buffer_.data(), buffer_.size()));
+            if (count < 0) {
+                throw runtime_error(string(strerror(errno)) + ": " + path_);
+            }
+            if (count == 0) {
+                return false;
+            }
+            pos_ = 0;
+            end_ = count;
+        }
+        const auto record(buffer_.data() + pos_);
+        unsigned short size;
+        memcpy(&size, record + offsetof(Dirent64, d_reclen), sizeof(size));
+        pos_ += size;
+        const auto name(record + offsetof(Dirent64, d_name));
+        if (is_special(name)) {
+            continue;
+        }
+        std::uint64_t inode;
+        memcpy(&inode, record + offsetof(Dirent64, d_ino), sizeof(inode));
+        const auto type(static_cast<unsigned char>(record[offsetof(Dirent64, d_type)]));
+        entry_ = DirEntry(path_, name, type, inode);
+        return true;
+    }
+#else
+    while (true) {
+        errno = 0;
+        const auto entry(readdir(dir_));
+        if (not entry) {
+            if (errno != 0) {
+                throw runtime_error(string(strerror(errno)) + ": " + path_);
+            }
+            return false;
+        }
+        if (not is_special(entry->d_name)) {
+            entry_ = DirEntry(path_, entry->d_name, entry->d_type, entry->d_ino);
+            return true;
+        }
+    }
+#endif
+}
+
+
+os::ScandirIterator os::scandir(const string& path) {
+    return ScandirIterator(path);
+}
+
+
 string os::getcwd() {
     char cwd[PATH_MAX];
     if (not ::getcwd(cwd, sizeof(cwd))) {
@@ -37,62 +463,163 @@ void os::chdir(const string& path) {
 
 
 vector<string> os::listdir(const string& path) {
-    static const vector<string> special({".", ".."});
     vector<string> names;
-    errno = 0;  // POSIX requires this to be thread-safe
-    auto dir(opendir(path.c_str()));
-    if (errno != 0) {
-        throw runtime_error(string(strerror(errno)) + ": " + path);
-    }
-    const auto first(begin(special));
-    const auto last(end(special));
-    dirent* entry;
-    while ((entry = readdir(dir))) {
-        if (not func::in(entry->d_name, first, last)) {
-            names.emplace_back(entry->d_name);
-        }
-    }
-    closedir(dir);
-    if (errno != 0) {
-        throw runtime_error(strerror(errno));
+    for (const auto& entry: scandir(path)) {
+        names.emplace_back(entry.name());
     }
     return names;
 }
 
 
 void os::makedirs(const string& path, mode_t mode, bool exist_ok) {
-    if (not path::isdir(path)) {
-        const auto root(path::dirname(path));
-        if (not (root.empty() or path::isdir(root))) {
-            // Recursively create root directories as needed.
-            makedirs(root, mode, false);
-        }
-        if (mkdir(path.c_str(), mode) != 0) {
-            if (not (errno == EEXIST or errno == EISDIR)) {
-                // Check that this error isn't due to a race condition where
-                // the directory was created by another thread/process.
-                throw runtime_error(strerror(errno));
-            }
+    if (path::isdir(path)) {
+        if (not exist_ok) {
+            throw runtime_error("directory exists: " + path);
+        }
+        return;
+    }
+    // Find the missing ancestors, closest first, then create them starting
+    // with the most distant one.
+    vector<string> missing;
+    for (const auto root: path::Ancestors(path, path::SEP)) {
+        string dir(root);
+        if (path::isdir(dir)) {
+            break;
         }
+        missing.emplace_back(std::move(dir));
     }
-    else if (not exist_ok) {
-        throw runtime_error("directory exists: " + path);
+    for (auto iter(missing.rbegin()); iter != missing.rend(); ++iter) {
+        make_dir(*iter, mode);
     }
+    make_dir(path, mode);
     return;
 }
 
 
 void os::removedirs(const string& path) {
-    auto pair(path::split(path));
-    if (pair.second.empty()) {
-        // Handle path with trailing slash.
-        pair = path::split(path);
+    // Remove as many ancestor directories as possible, stopping silently on
+    // failure.
+    // TODO: Mimic Python and report failure for initial directory.
+    if (rmdir(path.c_str()) != 0) {
+        return;
+    }
+    for (const auto root: path::Ancestors(path, path::SEP)) {
+        if (rmdir(string(root).c_str()) != 0) {
+            break;
+        }
+    }
+    return;
+}
+
+
+os::WalkIterator::WalkIterator(const string& top, bool topdown, WalkError onerror, bool followlinks):
+    topdown_(topdown),
+    onerror_(std::move(onerror)),
+    followlinks_(followlinks) {
+    if (topdown_) {
+        pending_.emplace_back(top);
+    }
+    else {
+        Frame frame{{}, {}, 0};
+        if (scan_dir(top, onerror_, frame.entry, links_)) {
+            for (const auto& name: frame.entry.dirnames) {
+                if (descend(name, links_, followlinks_)) {
+                    frame.subdirs.emplace_back(name);
+                }
+            }
+            frames_.emplace_back(std::move(frame));
+        }
+    }
+    next();
+}
+
+
+bool os::WalkIterator::active() const {
+    return active_;
+}
+
+
+os::WalkEntry os::WalkIterator::value() const {
+    return entry_;
+}
+
+
+vector<string>& os::WalkIterator::dirnames() {
+    return entry_.dirnames;
+}
+
+
+void os::WalkIterator::next() {
+    if (topdown_) {
+        // Schedule the subdirectories of the current directory in reverse so
+        // that they are visited in order. The list of subdirectories may have
+        // been modified by the caller.
+        for (auto name(entry_.dirnames.rbegin()); name != entry_.dirnames.rend(); ++name) {
+            if (descend(*name, links_, followlinks_)) {
+                pending_.emplace_back(join_name(entry_.dirpath, *name));
+            }
+        }
+        while (not pending_.empty()) {
+            const auto path(std::move(pending_.back()));
+            pending_.pop_back();
+            if (scan_dir(path, onerror_, entry_, links_)) {
+                return;
+            }
+        }
     }
-    if (rmdir(pair.second.c_str()) == 0) {
-        // Use recursion to remove as many root directories as possible,
-        // stopping silently on failure.
-        // TODO: Mimic Python and report failure for initial directory.
-        removedirs(pair.first);
+    else {
+        // Visit all subdirectories of a directory before generating it.
+        while (not frames_.empty()) {
+            auto& frame(frames_.back());
+            if (frame.next < frame.subdirs.size()) {
+                const auto path(join_name(frame.entry.dirpath, frame.subdirs[frame.next++]));
+                Frame child{{}, {}, 0};
+                if (scan_dir(path, onerror_, child.entry, links_)) {
+                    for (const auto& name: child.entry.dirnames) {
+                        if (descend(name, links_, followlinks_)) {
+                            child.subdirs.emplace_back(name);
+                        }
+                    }
+                    frames_.emplace_back(std::move(child));
+                }
+                continue;
+            }
+            entry_ = std::move(frame.entry);
+            frames_.pop_back();
+            return;
+        }
     }
+    active_ = false;
+    return;
+}
+
+
+os::WalkIterator os::walk(const string& top, bool topdown, WalkError onerror, bool followlinks) {
+    return WalkIterator(top, topdown, std::move(onerror), followlinks);
+}
+
+
+void os::walk_parallel(const string& top, const std::function<void(WalkEntry&)>& callback,
+                       WalkError onerror, bool followlinks, size_t threads) {
+    // Each directory is a separate task, and its subdirectories are submitted
+    // as new tasks after the callback has had a chance to prune them.
+    threadpool::ThreadPool pool(threads);
+    std::function<void(const string&)> visit;
+    visit = [&](const string& path) {
+        WalkEntry entry;
+        vector<string> links;
+        if (not scan_dir(path, onerror, entry, links)) {
+            return;
+        }
+        callback(entry);
+        for (const auto& name: entry.dirnames) {
+            if (descend(name, links, followlinks)) {
+                const auto child(join_name(entry.dirpath, name));
+                pool.submit([&visit, child]() { visit(child); });
+            }
+        }
+    };
+    pool.submit([&visit, &top]() { visit(top); });
+    pool.wait();
     return;
 }
@@ -2,8 +2,11 @@
  * Implementations of the 'path' module.
  */
 #include "unistd.h"
+#include "fcntl.h"
+#include "sys/mman.h"
 #include "sys/stat.h"
-#include "dirent.h"
+#include "sys/uio.h"
+#include <cerrno>
 #include <cstdio>
 #include <cstring>
 #include <algorithm>
@@ -11,14 +14,13 @@
 #include <map>
 #include <memory>
 #include <stdexcept>
-#include <sstream>
 #include <utility>
-#include "pypp/func.hpp"
+#include "pypp/glob.hpp"
 #include "pypp/os.hpp"
 #include "pypp/path.hpp"
 #include "pypp/string.hpp"
+#include "../simd.hpp"
 
-using pypp::func::in;
 using pypp::os::getcwd;
 using pypp::os::makedirs;
 using pypp::str::endswith;
@@ -32,25 +34,100 @@ using std::ios_base;
 using std::invalid_argument;
 using std::make_pair;
 using std::map;
+using std::max;
+using std::min;
 using std::mismatch;
 using std::move;
-using std::ostringstream;
 using std::pair;
 using std::prev;
 using std::remove;
 using std::runtime_error;
+using std::size_t;
 using std::string;
 using std::tie;
 using std::unique_ptr;
 using std::vector;
 
 using namespace pypp;
+using path::FileWriter;
+using path::LineReader;
+using path::MappedFile;
+using path::PathInfo;
 using path::PurePosixPath;
 using path::PosixPath;
+using str::StringView;
 
 
 const char path::SEP(PYPP_POSIX_SEP);
 
+const size_t LineReader::default_buffer_size(64 * 1024);
+
+const size_t FileWriter::default_buffer_size(64 * 1024);
+
+
+namespace {
+
+/// Block size for reading files of unknown size.
+///
+const size_t read_block_size(64 * 1024);
+
+
+/// Read from a file descriptor.
+///
+/// The read is retried if it is interrupted by a signal.
+///
+/// @param fd file descriptor
+/// @param buffer output buffer
+/// @param size buffer size
+/// @return number of bytes read, or -1 on error
+ssize_t read_fd(int fd, char* buffer, size_t size) {
+    ssize_t count;
+    do {
+        count = read(fd, buffer, size);
+    } while (count < 0 and errno == EINTR);
+    return count;
+}
+
+
+/// Write a sequence of buffers to a file descriptor.
+///
+/// Partial writes are resumed until all data has been written. The buffer
+/// descriptors are modified in the process.
+///
+/// @param fd file descriptor
+/// @param iov buffers
+/// @param count number of buffers
+/// @param path file path for error messages
+void write_fd(int fd, struct iovec* iov, int count, const string& path) {
+    while (count > 0) {
+        if (iov->iov_len == 0) {
+            ++iov;
+            --count;
+            continue;
+        }
+        const auto written(writev(fd, iov, count));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw runtime_error(string(strerror(errno)) + ": " + path);
+        }
+        for (auto size(static_cast<size_t>(written)); size > 0; ) {
+            const auto used(min(size, iov->iov_len));
+            iov->iov_base = static_cast<char*>(iov->iov_base) + used;
+            iov->iov_len -= used;
+            size -= used;
+            if (iov->iov_len == 0) {
+                ++iov;
+                --count;
+            }
+        }
+    }
+    return;
+}
+
+}  // internal linkage
+
 
 // In the Python implementation a Path inherits from a PurePath, and
 // metaprogramming is used to ensure that methods return an object of the
@@ -85,6 +162,21 @@ bool path::islink(const string& path) {
 }
 
 
+bool path::isfile(const os::stat_result& status) {
+    return S_ISREG(status.st_mode);
+}
+
+
+bool path::isdir(const os::stat_result& status) {
+    return S_ISDIR(status.st_mode);
+}
+
+
+bool path::islink(const os::stat_result& status) {
+    return S_ISLNK(status.st_mode);
+}
+
+
 // Implement the PurePath portion of the Path API.
 
 PosixPath::PosixPath(const std::string& path):
@@ -115,7 +207,7 @@ std::string PosixPath::name() const
 }
 
 
-const vector<string>& PosixPath::parts() const
+vector<string> PosixPath::parts() const
 {
     return base_.parts();
 }
@@ -163,6 +255,12 @@ bool PosixPath::operator<(const PosixPath& other) const
 }
 
 
+size_t PosixPath::hash() const
+{
+    return base_.hash();
+}
+
+
 PosixPath PosixPath::joinpath(const PosixPath& path) const
 {
     return PosixPath(base_.joinpath(path.base_));
@@ -210,13 +308,18 @@ PosixPath PosixPath::parent() const
 vector<PosixPath> PosixPath::parents() const
 {
     vector<PosixPath> result;
-    for (const auto& path: base_.parents()) {
-        // Convert each item to the correct type.
-        result.emplace_back(PosixPath(path));
+    for (const auto path: base_.ancestors()) {
+        result.emplace_back(string(path));
     }
     return result;
 }
 
+
+path::Ancestors PosixPath::ancestors() const
+{
+    return base_.ancestors();
+}
+
 PosixPath PosixPath::relative_to(const PosixPath& other) const
 {
     return PosixPath(base_.relative_to(other.base_));
@@ -251,6 +354,24 @@ PurePosixPath PosixPath::pure() const
 }
 
 
+os::stat_result PosixPath::stat(bool follow_symlinks) const
+{
+    return os::stat(string(*this), follow_symlinks);
+}
+
+
+os::stat_result PosixPath::lstat() const
+{
+    return os::lstat(string(*this));
+}
+
+
+PathInfo PosixPath::info() const
+{
+    return PathInfo(string(*this));
+}
+
+
 bool PosixPath::exists() const
 {
     return path::exists(string(*this));
@@ -361,13 +482,19 @@ void PosixPath::rmdir() const
 
 string PosixPath::read_bytes() const
 {
-    return read_file("rb");
+    return read_file();
 }
 
 
 string PosixPath::read_text() const
 {
-    return read_file("rt");
+    return read_file();
+}
+
+
+LineReader PosixPath::lines(bool keepends, size_t buffer_size) const
+{
+    return LineReader(string(*this), keepends, buffer_size);
 }
 
 
@@ -385,14 +512,53 @@ void PosixPath::write_text(const string& data) const
 }
 
 
-string PosixPath::read_file(const string& mode) const
+string PosixPath::read_file() const
 {
-    auto stream(open(mode));
-    ostringstream buffer;
-    if (not (buffer << stream.rdbuf())) {
-        throw runtime_error("could not read data from " + string(*this));
+    const string path(*this);
+    const auto fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (fd < 0) {
+        throw runtime_error(string(strerror(errno)) + ": " + path);
+    }
+    // The size of a regular file is known in advance, so it is read with a
+    // single call into the result. Other files, e.g. pipes or procfs files,
+    // report a size of zero and are read in blocks.
+    struct stat status;
+    string data;
+    if (fstat(fd, &status) == 0 and S_ISREG(status.st_mode)) {
+        data.resize(status.st_size);
     }
-    return buffer.str();  // is this a move (good) or copy (bad)?
+    size_t size(0);
+    while (true) {
+        if (size == data.size()) {
+            // Check for EOF before growing the buffer so that a file of the
+            // expected size is never reallocated.
+            char next;
+            const auto count(read_fd(fd, &next, 1));
+            if (count <= 0) {
+                if (count < 0) {
+                    const auto error(errno);
+                    close(fd);
+                    throw runtime_error(string(strerror(error)) + ": " + path);
+                }
+                break;
+            }
+            data.resize(max(2 * size, size + read_block_size));
+            data[size++] = next;
+        }
+        const auto count(read_fd(fd, &data[size], data.size() - size));
+        if (count < 0) {
+            const auto error(errno);
+            close(fd);
+            throw runtime_error(string(strerror(error)) + ": " + path);
+        }
+        if (count == 0) {
+            break;
+        }
+        size += count;
+    }
+    close(fd);
+    data.resize(size);
+    return data;
 }
 
 
@@ -406,32 +572,393 @@ void PosixPath::write_file(const string& data, const string& mode) const
 }
 
 
+FileWriter PosixPath::writer(bool append, size_t buffer_size) const
+{
+    return FileWriter(string(*this), append, buffer_size);
+}
+
+
 vector<PosixPath> PosixPath::iterdir() const
 {
-    // Implementing this in terms of os::listdir() would require the conversion
-    // of a vector<string> to a vector<PosixPath>. This would either double the
-    // memory usage or require additional complexity to reduce the size of the
-    // original list as the new list is populated. Instead, this is a copy of
-    // the os::listdir() implementation with some type-specific tweaks.
-    static const vector<string> special({".", ".."});
-    const string path(*this);
-    errno = 0;  // POSIX requires this to be thread-safe
-    auto dir(opendir(path.c_str()));
-    if (errno != 0) {
+    vector<PosixPath> entries;
+    for (const auto& entry: scandir()) {
+        entries.emplace_back(*this / entry.name());
+    }
+    return entries;
+}
+
+
+os::ScandirIterator PosixPath::scandir() const
+{
+    return os::scandir(string(*this));
+}
+
+
+vector<PosixPath> PosixPath::glob(const string& pattern) const
+{
+    if (pattern.empty() or pattern[0] == '/') {
+        throw invalid_argument("unacceptable pattern: '" + pattern + "'");
+    }
+    vector<PosixPath> paths;
+    const auto base(pypp::glob::escape(string(*this)));
+    for (const auto& path: pypp::glob::glob(base + '/' + pattern, true)) {
+        paths.emplace_back(path);
+    }
+    return paths;
+}
+
+
+vector<PosixPath> PosixPath::rglob(const string& pattern) const
+{
+    return glob("**/" + pattern);
+}
+
+
+LineReader::LineReader(const string& path, bool keepends, size_t buffer_size):
+    path_(path),
+    fd_(-1),
+    keepends_(keepends),
+    buffer_(max(buffer_size, size_t(1)))
+{
+    // The file is opened after the buffer is allocated, and it is closed if
+    // reading the first line fails because the destructor will not run.
+    fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
         throw runtime_error(string(strerror(errno)) + ": " + path);
     }
-    vector<PosixPath> entries;
-    const auto first(begin(special));
-    const auto last(end(special));
-    dirent* entry;
-    while ((entry = readdir(dir))) {
-        if (not in(entry->d_name, first, last)) {
-            entries.emplace_back(*this / PosixPath(entry->d_name));
+    try {
+        next();
+    }
+    catch (...) {
+        close(fd_);
+        throw;
+    }
+}
+
+
+LineReader::LineReader(LineReader&& other) noexcept:
+    path_(move(other.path_)),
+    fd_(other.fd_),
+    keepends_(other.keepends_),
+    eof_(other.eof_),
+    active_(other.active_),
+    buffer_(move(other.buffer_)),
+    beg_(other.beg_),
+    end_(other.end_),
+    line_(other.line_)
+{
+    // The current line is a view into the buffer, which is not reallocated by
+    // moving it.
+    other.fd_ = -1;
+    other.active_ = false;
+}
+
+
+LineReader::~LineReader()
+{
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+}
+
+
+bool LineReader::active() const
+{
+    return active_;
+}
+
+
+StringView LineReader::value() const
+{
+    return line_;
+}
+
+
+void LineReader::next()
+{
+    auto scan(beg_);
+    while (true) {
+        const auto first(buffer_.data());
+        const auto eol(static_cast<size_t>(simd::find_eol(first + scan, first + end_) - first));
+        if (eol < end_ and (buffer_[eol] != '\r' or eol + 1 < end_ or eof_)) {
+            // A "\r" at the end of the buffer could be the start of "\r\n", so
+            // it is not a complete line ending until more data is read.
+            auto term(eol + 1);
+            if (buffer_[eol] == '\r' and term < end_ and buffer_[term] == '\n') {
+                ++term;
+            }
+            line_ = {first + beg_, (keepends_ ? term : eol) - beg_};
+            beg_ = term;
+            return;
         }
+        if (eof_) {
+            // The last line does not have a line ending.
+            active_ = beg_ < end_;
+            line_ = {first + beg_, end_ - beg_};
+            beg_ = end_;
+            return;
+        }
+        scan = fill(eol);
     }
-    closedir(dir);
-    if (errno != 0) {
-        throw runtime_error(strerror(errno));
+}
+
+
+size_t LineReader::fill(size_t scan)
+{
+    if (beg_ > 0) {
+        copy(buffer_.begin() + beg_, buffer_.begin() + end_, buffer_.begin());
+        scan -= beg_;
+        end_ -= beg_;
+        beg_ = 0;
     }
-    return entries;
+    if (end_ == buffer_.size()) {
+        // The current line is longer than the buffer.
+        buffer_.resize(buffer_.size() * 2);
+    }
+    const auto count(read_fd(fd_, buffer_.data() + end_, buffer_.size() - end_));
+    if (count < 0) {
+        throw runtime_error(string(strerror(errno)) + ": " + path_);
+    }
+    eof_ = count == 0;
+    end_ += count;
+    return scan;
+}
+
+
+MappedFile::MappedFile(const string& path, int advice)
+{
+    const auto fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (fd < 0) {
+        throw runtime_error(string(strerror(errno)) + ": " + path);
+    }
+    struct stat status;
+    const auto result(fstat(fd, &status));
+    if (result != 0 or not S_ISREG(status.st_mode)) {
+        const auto error(result != 0 ? errno : EINVAL);
+        close(fd);
+        throw runtime_error(string(strerror(error)) + ": " + path);
+    }
+    size_ = status.st_size;
+    if (size_ > 0) {
+        // An empty file cannot be mapped. The mapping remains valid after the
+        // file is closed.
+        const auto data(mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0));
+        const auto error(errno);
+        close(fd);
+        if (data == MAP_FAILED) {
+            throw runtime_error(string(strerror(error)) + ": " + path);
+        }
+        data_ = static_cast<const char*>(data);
+        advise(advice);
+    }
+    else {
+        close(fd);
+    }
+}
+
+
+MappedFile::MappedFile(MappedFile&& other) noexcept:
+    data_(other.data_),
+    size_(other.size_)
+{
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+
+MappedFile::~MappedFile()
+{
+    if (data_) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+}
+
+
+StringView MappedFile::view() const
+{
+    return {data_, size_};
+}
+
+
+const char* MappedFile::data() const
+{
+    return data_;
+}
+
+
+size_t MappedFile::size() const
+{
+    return size_;
+}
+
+
+void MappedFile::advise(int advice) const
+{
+    // This is only a hint, so errors are ignored.
+    if (data_) {
+        madvise(const_cast<char*>(data_), size_, advice);
+    }
+    return;
+}
+
+
+FileWriter::FileWriter(const string& path, bool append, size_t buffer_size):
+    path_(path),
+    fd_(::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC), 0666)),
+    capacity_(buffer_size)
+{
+    if (fd_ < 0) {
+        throw runtime_error(string(strerror(errno)) + ": " + path);
+    }
+    buffer_.reserve(capacity_);
+}
+
+
+FileWriter::FileWriter(FileWriter&& other) noexcept:
+    path_(move(other.path_)),
+    fd_(other.fd_),
+    capacity_(other.capacity_),
+    buffer_(move(other.buffer_))
+{
+    other.fd_ = -1;
+}
+
+
+FileWriter::~FileWriter()
+{
+    try {
+        close();
+    }
+    catch (const runtime_error&) {
+        // Errors cannot be reported here.
+    }
+}
+
+
+void FileWriter::write(StringView data)
+{
+    if (fd_ < 0) {
+        throw runtime_error("I/O operation on closed file: " + path_);
+    }
+    if (buffer_.size() + data.size() <= capacity_) {
+        buffer_.append(data.data(), data.size());
+        return;
+    }
+    struct iovec iov[2] = {
+        {&buffer_[0], buffer_.size()},
+        {const_cast<char*>(data.data()), data.size()},
+    };
+    write_fd(fd_, iov, 2, path_);
+    buffer_.clear();
+    return;
+}
+
+
+void FileWriter::flush()
+{
+    if (fd_ < 0) {
+        throw runtime_error("I/O operation on closed file: " + path_);
+    }
+    struct iovec iov = {&buffer_[0], buffer_.size()};
+    write_fd(fd_, &iov, 1, path_);
+    buffer_.clear();
+    return;
+}
+
+
+void FileWriter::close()
+{
+    if (fd_ < 0) {
+        return;
+    }
+    struct iovec iov = {&buffer_[0], buffer_.size()};
+    const auto fd(fd_);
+    fd_ = -1;  // closed even if the write fails
+    try {
+        write_fd(fd, &iov, 1, path_);
+    }
+    catch (...) {
+        buffer_.clear();
+        ::close(fd);
+        throw;
+    }
+    buffer_.clear();
+    if (::close(fd) != 0) {
+        throw runtime_error(string(strerror(errno)) + ": " + path_);
+    }
+    return;
+}
+
+
+PathInfo::PathInfo(string path):
+    path_(move(path))
+{}
+
+
+bool PathInfo::exists(bool follow_symlinks) const
+{
+    return status(follow_symlinks) != nullptr;
+}
+
+
+bool PathInfo::is_dir(bool follow_symlinks) const
+{
+    const auto status(this->status(follow_symlinks));
+    return status and path::isdir(*status);
+}
+
+
+bool PathInfo::is_file(bool follow_symlinks) const
+{
+    const auto status(this->status(follow_symlinks));
+    return status and path::isfile(*status);
+}
+
+
+bool PathInfo::is_symlink() const
+{
+    const auto status(this->status(false));
+    return status and path::islink(*status);
+}
+
+
+const os::stat_result& PathInfo::stat(bool follow_symlinks) const
+{
+    const auto status(this->status(follow_symlinks));
+    if (not status) {
+        throw runtime_error(string(strerror(follow_symlinks ? stat_error_ : lstat_error_)) + ": " + path_);
+    }
+    return *status;
+}
+
+
+const os::stat_result* PathInfo::status(bool follow_symlinks) const
+{
+    if (lstat_error_ < 0) {
+        // Always start with lstat(). For anything other than a symlink, the
+        // result is the same as stat(), so that call is not needed.
+        struct stat status;
+        lstat_error_ = ::lstat(path_.c_str(), &status) == 0 ? 0 : errno;
+        if (lstat_error_ == 0) {
+            lstat_ = os::stat_result(status);
+            if (not S_ISLNK(status.st_mode)) {
+                stat_ = lstat_;
+                stat_error_ = 0;
+            }
+        }
+        else if (lstat_error_ == ENOENT or lstat_error_ == ENOTDIR) {
+            stat_error_ = lstat_error_;  // stat() would fail too
+        }
+    }
+    if (not follow_symlinks) {
+        return lstat_error_ == 0 ? &lstat_ : nullptr;
+    }
+    if (stat_error_ < 0) {
+        struct stat status;
+        stat_error_ = ::stat(path_.c_str(), &status) == 0 ? 0 : errno;
+        if (stat_error_ == 0) {
+            stat_ = os::stat_result(status);
+        }
+    }
+    return stat_error_ == 0 ? &stat_ : nullptr;
 }
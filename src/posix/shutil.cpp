@@ -0,0 +1,224 @@
+/// POSIX implementation of the 'shutil' module.
+///
+#include "dirent.h"
+#include "fcntl.h"
+#include "unistd.h"
+#include "sys/stat.h"
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "pypp/path.hpp"
+#include "pypp/shutil.hpp"
+#include "../threadpool.hpp"
+
+
+using std::runtime_error;
+using std::size_t;
+using std::strerror;
+using std::string;
+using std::vector;
+
+using namespace pypp;
+
+
+namespace {
+
+/// Directory entry read by rmtree().
+///
+struct Entry {
+    string name;  ///< entry name
+    bool dir;     ///< entry is a directory (and not a symlink)
+};
+
+
+/// Open directory stream that is closed on destruction.
+///
+class Directory {
+public:
+    /// Open a directory.
+    ///
+    /// Symbolic links are not followed. On failure, the object evaluates to
+    /// false and `errno` is set.
+    ///
+    /// @param parent parent directory descriptor, or AT_FDCWD
+    /// @param name path relative to the parent directory
+    Directory(int parent, const char* name) {
+        const auto fd(openat(parent, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC));
+        if (fd >= 0 and not (dir_ = fdopendir(fd))) {
+            const auto error(errno);
+            close(fd);
+            errno = error;
+        }
+    }
+
+    Directory(const Directory&) = delete;
+
+    Directory& operator=(const Directory&) = delete;
+
+    ~Directory() {
+        if (dir_) {
+            closedir(dir_);
+        }
+    }
+
+    /// Determine if the directory is open.
+    ///
+    /// @return true if the directory is open
+    explicit operator bool() const {
+        return dir_ != nullptr;
+    }
+
+    /// Get the directory descriptor.
+    ///
+    /// @return file descriptor
+    int fd() const {
+        return dirfd(dir_);
+    }
+
+    /// Read all entries.
+    ///
+    /// The directory is read completely before anything is removed because
+    /// the effect of removing entries from an open directory stream is
+    /// unspecified. A stat() call is only needed if the file system does not
+    /// report entry types.
+    ///
+    /// @param entries output entries
+    /// @return true on success, otherwise `errno` is set
+    bool read(vector<Entry>& entries) {
+        errno = 0;
+        while (const auto item = readdir(dir_)) {
+            const auto name(item->d_name);
+            if (name[0] == '.' and (name[1] == '\0' or (name[1] == '.' and name[2] == '\0'))) {
+                continue;  // special entry
+            }
+            auto dir(item->d_type == DT_DIR);
+            if (item->d_type == DT_UNKNOWN) {
+                struct stat status;
+                dir = fstatat(fd(), name, &status, AT_SYMLINK_NOFOLLOW) == 0 and S_ISDIR(status.st_mode);
+            }
+            entries.push_back({name, dir});
+            errno = 0;
+        }
+        return errno == 0;
+    }
+
+private:
+    DIR* dir_{nullptr};
+};
+
+
+/// Report an rmtree() error.
+///
+/// @param path path that caused the error
+/// @param ignore_errors ignore the error instead of throwing an exception
+/// @param error error number
+void fail(const string& path, bool ignore_errors, int error) {
+    if (not ignore_errors) {
+        throw runtime_error(string(strerror(error)) + ": " + path);
+    }
+    return;
+}
+
+
+/// Remove a directory tree relative to an open parent directory.
+///
+/// Full paths are only built for subdirectories, for use in error messages.
+///
+/// @param parent parent directory descriptor, or AT_FDCWD
+/// @param name directory path relative to the parent directory
+/// @param path directory path for error messages
+/// @param ignore_errors ignore errors instead of throwing an exception
+void remove_tree(int parent, const string& name, const string& path, bool ignore_errors) {
+    {
+        Directory dir(parent, name.c_str());
+        if (not dir) {
+            fail(path, ignore_errors, errno);
+            return;
+        }
+        vector<Entry> entries;
+        if (not dir.read(entries)) {
+            fail(path, ignore_errors, errno);
+        }
+        for (const auto& entry: entries) {
+            if (entry.dir) {
+                remove_tree(dir.fd(), entry.name, path::join({path, entry.name}), ignore_errors);
+            }
+            else if (unlinkat(dir.fd(), entry.name.c_str(), 0) != 0) {
+                fail(path::join({path, entry.name}), ignore_errors, errno);
+            }
+        }
+    }  // close before removing
+    if (unlinkat(parent, name.c_str(), AT_REMOVEDIR) != 0) {
+        fail(path, ignore_errors, errno);
+    }
+    return;
+}
+
+
+/// Remove all files in a directory tree using a thread pool.
+///
+/// Each subdirectory is a separate task. As for remove_tree(), directories
+/// are opened relative to their parent, which each task shares ownership of
+/// until its own directory is open. Directories themselves are not removed.
+///
+/// @param pool thread pool
+/// @param parent parent directory, or null for the current directory
+/// @param name directory path relative to the parent directory
+/// @param path directory path for error messages
+/// @param ignore_errors ignore errors instead of throwing an exception
+void remove_files(threadpool::ThreadPool& pool, std::shared_ptr<Directory> parent, const string& name,
+                  const string& path, bool ignore_errors) {
+    const auto dir(std::make_shared<Directory>(parent ? parent->fd() : AT_FDCWD, name.c_str()));
+    parent.reset();
+    if (not *dir) {
+        fail(path, ignore_errors, errno);
+        return;
+    }
+    vector<Entry> entries;
+    if (not dir->read(entries)) {
+        fail(path, ignore_errors, errno);
+    }
+    for (const auto& entry: entries) {
+        if (entry.dir) {
+            const auto child(entry.name);
+            const auto child_path(path::join({path, entry.name}));
+            pool.submit([&pool, dir, child, child_path, ignore_errors]() {
+                remove_files(pool, dir, child, child_path, ignore_errors);
+            });
+        }
+        else if (unlinkat(dir->fd(), entry.name.c_str(), 0) != 0) {
+            fail(path::join({path, entry.name}), ignore_errors, errno);
+        }
+    }
+    return;
+}
+
+}  // internal linkage
+
+
+void shutil::rmtree(const string& path, bool ignore_errors, size_t threads) {
+    struct stat status;
+    if (lstat(path.c_str(), &status) != 0) {
+        fail(path, ignore_errors, errno);
+        return;
+    }
+    if (S_ISLNK(status.st_mode)) {
+        // Following a link could delete files outside of the tree.
+        if (not ignore_errors) {
+            throw runtime_error("cannot call rmtree on a symbolic link: " + path);
+        }
+        return;
+    }
+    if (threads != 1) {
+        // Removing files is the bulk of the work, and the remaining empty
+        // directories are removed serially.
+        threadpool::ThreadPool pool(threads);
+        pool.submit([&pool, &path, ignore_errors]() { remove_files(pool, nullptr, path, path, ignore_errors); });
+        pool.wait();
+    }
+    remove_tree(AT_FDCWD, path, path, ignore_errors);
+    return;
+}
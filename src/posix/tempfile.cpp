@@ -11,6 +11,7 @@
 #include "pypp/func.hpp"
 #include "pypp/os.hpp"
 #include "pypp/path.hpp"
+#include "pypp/shutil.hpp"
 #include "pypp/tempfile.hpp"
 
 
@@ -26,6 +27,7 @@ using std::runtime_error;
 using std::string;
 using std::vector;
 
+using namespace pypp;
 using namespace pypp::tempfile;
 
 
@@ -97,16 +99,23 @@ TemporaryDirectory::~TemporaryDirectory()
 
 void TemporaryDirectory::rmtree(const Path& root, bool delroot)
 {
-    for (const auto& item: root.iterdir()) {
-        if (not item.is_dir()) {
-            item.unlink();
-        }
-        else {
-            rmtree(item, true);
-        }
-    }
+    // The root directory is kept by cleanup(), so its contents are removed
+    // here, and shutil::rmtree() does the rest. Symlinks to directories are
+    // removed, not followed.
     if (delroot) {
-        root.rmdir();
+        shutil::rmtree(string(root));
+        return;
+    }
+    vector<string> dirs;
+    vector<string> files;
+    for (const auto& entry: root.scandir()) {
+        (entry.is_dir(false) ? dirs : files).emplace_back(entry.path());
+    }
+    for (const auto& file: files) {
+        Path(file).unlink();
+    }
+    for (const auto& dir: dirs) {
+        shutil::rmtree(dir);
     }
     return;
 }
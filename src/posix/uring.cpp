@@ -0,0 +1,337 @@
+/// Implementation of batched system calls using Linux io_uring.
+///
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define PYPP_HAVE_IO_URING 1
+#endif
+#endif
+
+#if defined(PYPP_HAVE_IO_URING)
+#include "fcntl.h"
+#include "unistd.h"
+#include "sys/mman.h"
+#include "sys/stat.h"
+#include "sys/syscall.h"
+#include "sys/sysmacros.h"
+#include <linux/io_uring.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#endif
+#include "uring.hpp"
+
+
+using std::string;
+using std::vector;
+
+using namespace pypp;
+
+
+#if defined(PYPP_HAVE_IO_URING)
+
+namespace {
+
+/// Maximum number of requests in flight.
+///
+const unsigned ring_entries(256);
+
+
+/// Convert a statx timestamp to nanoseconds.
+///
+/// @param time timestamp
+/// @return nanoseconds since the epoch
+std::int64_t nanoseconds(const struct statx_timestamp& time) {
+    return static_cast<std::int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+
+
+/// Convert a statx result.
+///
+/// @param status statx result
+/// @param result output file status
+void convert(const struct statx& status, os::stat_result& result) {
+    result.st_mode = status.stx_mode;
+    result.st_ino = status.stx_ino;
+    result.st_dev = makedev(status.stx_dev_major, status.stx_dev_minor);
+    result.st_nlink = status.stx_nlink;
+    result.st_uid = status.stx_uid;
+    result.st_gid = status.stx_gid;
+    result.st_size = status.stx_size;
+    result.st_atime_ns = nanoseconds(status.stx_atime);
+    result.st_mtime_ns = nanoseconds(status.stx_mtime);
+    result.st_ctime_ns = nanoseconds(status.stx_ctime);
+    return;
+}
+
+
+/// Submission and completion queues of an io_uring instance.
+///
+/// Only what is needed for simple request batches is implemented. The queues
+/// are shared with the kernel, so the indexes owned by the kernel are read
+/// with acquire semantics, and the indexes owned by this process are written
+/// with release semantics.
+///
+class Ring {
+public:
+    /// Create a ring.
+    ///
+    /// The ring is invalid if io_uring is not available or does not support
+    /// statx requests.
+    ///
+    /// @param entries minimum number of submission queue entries
+    explicit Ring(unsigned entries) {
+        struct io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd_ = syscall(__NR_io_uring_setup, entries, &params);
+        if (fd_ < 0 or not supports(IORING_OP_STATX)) {
+            reset();
+            return;
+        }
+        sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+        sq_ptr_ = map(sq_size_, IORING_OFF_SQ_RING);
+        cq_ptr_ = map(cq_size_, IORING_OFF_CQ_RING);
+        const auto sqes(map(sqes_size_, IORING_OFF_SQES));
+        if (sq_ptr_ == MAP_FAILED or cq_ptr_ == MAP_FAILED or sqes == MAP_FAILED) {
+            if (sqes != MAP_FAILED) {
+                munmap(sqes, sqes_size_);
+            }
+            reset();
+            return;
+        }
+        const auto sq(static_cast<char*>(sq_ptr_));
+        sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        const auto cq(static_cast<char*>(cq_ptr_));
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+        sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+        tail_ = *sq_tail_;
+        capacity_ = params.sq_entries;
+    }
+
+    Ring(const Ring&) = delete;
+
+    Ring& operator=(const Ring&) = delete;
+
+    /// Close the ring.
+    ///
+    ~Ring() {
+        reset();
+    }
+
+    /// Determine if the ring is valid.
+    ///
+    /// @return true if the ring can be used
+    explicit operator bool() const {
+        return fd_ >= 0;
+    }
+
+    /// Get the number of submission queue entries.
+    ///
+    /// @return queue size
+    unsigned capacity() const {
+        return capacity_;
+    }
+
+    /// Get the next submission queue entry.
+    ///
+    /// The entry is cleared, and it is submitted by the next call to enter().
+    /// The caller is responsible for not exceeding capacity().
+    ///
+    /// @return submission queue entry
+    struct io_uring_sqe* next() {
+        const auto index(tail_++ & sq_mask_);
+        sq_array_[index] = index;
+        const auto sqe(sqes_ + index);
+        std::memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    }
+
+    /// Submit all pending requests and wait for completions.
+    ///
+    /// @param wait minimum number of completions to wait for
+    /// @return 0 on success, otherwise an error number
+    int enter(unsigned wait) {
+        __atomic_store_n(sq_tail_, tail_, __ATOMIC_RELEASE);
+        while (true) {
+            const auto pending(tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE));
+            const auto flags(wait > 0 ? IORING_ENTER_GETEVENTS : 0);
+            if (syscall(__NR_io_uring_enter, fd_, pending, wait, flags, nullptr, 0) >= 0) {
+                return 0;
+            }
+            if (errno != EINTR) {
+                return errno;
+            }
+        }
+    }
+
+    /// Process all available completions.
+    ///
+    /// @tparam Callback callable taking a completion queue entry
+    /// @param callback completion handler
+    template <typename Callback>
+    void reap(Callback callback) {
+        auto head(*cq_head_);
+        const auto tail(__atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE));
+        for (; head != tail; ++head) {
+            callback(cqes_[head & cq_mask_]);
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+        return;
+    }
+
+private:
+    int fd_{-1};
+    void* sq_ptr_{MAP_FAILED};
+    void* cq_ptr_{MAP_FAILED};
+    std::size_t sq_size_{0};
+    std::size_t cq_size_{0};
+    std::size_t sqes_size_{0};
+    unsigned* sq_head_{nullptr};
+    unsigned* sq_tail_{nullptr};
+    unsigned* sq_array_{nullptr};
+    unsigned sq_mask_{0};
+    unsigned* cq_head_{nullptr};
+    unsigned* cq_tail_{nullptr};
+    unsigned cq_mask_{0};
+    struct io_uring_cqe* cqes_{nullptr};
+    struct io_uring_sqe* sqes_{nullptr};
+    unsigned tail_{0};
+    unsigned capacity_{0};
+
+    /// Map a region of the ring.
+    ///
+    /// @param size region size
+    /// @param offset region offset
+    /// @return mapped address, or MAP_FAILED
+    void* map(std::size_t size, off_t offset) const {
+        return mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+    }
+
+    /// Determine if the kernel supports an operation.
+    ///
+    /// @param op operation code
+    /// @return true if the operation is supported
+    bool supports(unsigned op) const {
+        static const unsigned count(256);
+        vector<std::uint64_t> buffer((sizeof(struct io_uring_probe) + count * sizeof(struct io_uring_probe_op)) / 8 + 1);
+        const auto probe(reinterpret_cast<struct io_uring_probe*>(buffer.data()));
+        if (syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PROBE, probe, count) < 0) {
+            return false;
+        }
+        return op <= probe->last_op and (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+    }
+
+    /// Release all resources and invalidate the ring.
+    ///
+    void reset() {
+        if (sqes_) {
+            munmap(sqes_, sqes_size_);
+            sqes_ = nullptr;
+        }
+        if (cq_ptr_ != MAP_FAILED) {
+            munmap(cq_ptr_, cq_size_);
+            cq_ptr_ = MAP_FAILED;
+        }
+        if (sq_ptr_ != MAP_FAILED) {
+            munmap(sq_ptr_, sq_size_);
+            sq_ptr_ = MAP_FAILED;
+        }
+        if (fd_ >= 0) {
+            close(fd_);
+            fd_ = -1;
+        }
+        return;
+    }
+};
+
+}  // internal linkage
+
+
+bool uring::stat_many(const vector<string>& paths, bool follow_symlinks, vector<os::StatEntry>& results) {
+    Ring ring(std::min<std::size_t>(paths.size(), ring_entries));
+    if (not ring) {
+        return false;
+    }
+    // Each request in flight has its own output buffer, identified by the
+    // request's user data. Buffers are reused as requests complete.
+    const auto capacity(ring.capacity());
+    std::unique_ptr<struct statx[]> buffers(new struct statx[capacity]);
+    vector<std::size_t> owners(capacity);
+    vector<bool> busy(capacity, false);
+    vector<unsigned> slots;
+    for (auto slot(capacity); slot > 0; --slot) {
+        slots.emplace_back(slot - 1);
+    }
+    std::size_t next(0);
+    std::size_t inflight(0);
+    int error(0);
+    while (next < paths.size() or inflight > 0) {
+        for (; next < paths.size() and not slots.empty(); ++next) {
+            const auto slot(slots.back());
+            slots.pop_back();
+            owners[slot] = next;
+            busy[slot] = true;
+            ++inflight;
+            const auto sqe(ring.next());
+            sqe->opcode = IORING_OP_STATX;
+            sqe->fd = AT_FDCWD;
+            sqe->addr = reinterpret_cast<std::uint64_t>(paths[next].c_str());
+            sqe->addr2 = reinterpret_cast<std::uint64_t>(&buffers[slot]);
+            sqe->len = STATX_BASIC_STATS;
+            sqe->statx_flags = follow_symlinks ? 0 : AT_SYMLINK_NOFOLLOW;
+            sqe->user_data = slot;
+        }
+        if ((error = ring.enter(1)) != 0) {
+            break;
+        }
+        ring.reap([&](const struct io_uring_cqe& cqe) {
+            const auto slot(static_cast<unsigned>(cqe.user_data));
+            auto& result(results[owners[slot]]);
+            if (cqe.res < 0) {
+                result.error = -cqe.res;
+            }
+            else {
+                result.error = 0;
+                convert(buffers[slot], result.status);
+            }
+            busy[slot] = false;
+            slots.emplace_back(slot);
+            --inflight;
+        });
+    }
+    if (error != 0) {
+        // The ring failed after it was created, which is not expected. Any
+        // unfinished request gets the same error.
+        for (unsigned slot(0); slot < capacity; ++slot) {
+            if (busy[slot]) {
+                results[owners[slot]].error = error;
+            }
+        }
+        for (; next < paths.size(); ++next) {
+            results[next].error = error;
+        }
+        if (inflight > 0) {
+            // The kernel may still write to the buffers of requests in flight
+            // after the ring is closed, so they cannot be freed.
+            buffers.release();
+        }
+    }
+    return true;
+}
+
+#else
+
+bool uring::stat_many(const vector<string>&, bool, vector<os::StatEntry>&) {
+    return false;
+}
+
+#endif  // PYPP_HAVE_IO_URING
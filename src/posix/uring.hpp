@@ -0,0 +1,32 @@
+/// Batched system calls using Linux io_uring.
+///
+/// This is not part of the public API. The io_uring interface is used through
+/// raw system calls, so there is no dependency on liburing. On other platforms,
+/// or if the kernel does not support the required operations, the functions
+/// here report that io_uring is unavailable and the caller must fall back to
+/// ordinary system calls.
+///
+#ifndef PYPP_URING_HPP
+#define PYPP_URING_HPP
+
+#include <string>
+#include <vector>
+#include "pypp/os.hpp"
+
+
+namespace pypp { namespace uring {
+
+/// Get the status of many paths with io_uring statx requests.
+///
+/// Requests are submitted in batches so that many of them are in flight at
+/// once. Results are stored in input order, and errors are reported per entry.
+///
+/// @param paths file paths
+/// @param follow_symlinks get the status of the target of a symbolic link
+/// @param results output results, the same size as `paths`
+/// @return false if io_uring is unavailable, otherwise true
+bool stat_many(const std::vector<std::string>& paths, bool follow_symlinks, std::vector<os::StatEntry>& results);
+
+}}  // namespace pypp::uring
+
+#endif  // PYPP_URING_HPP
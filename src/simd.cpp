@@ -0,0 +1,618 @@
+/// Implementation of vectorized kernels.
+///
+/// x86 kernels are compiled with function-level target attributes so that the
+/// library itself does not need to be built for a specific instruction set.
+/// The best available kernel is selected the first time it is needed.
+///
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <utility>
+#include "simd.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define PYPP_SIMD_X86
+#include <immintrin.h>
+#endif
+
+
+namespace {
+
+/// Function signature for case conversion kernels.
+///
+using CaseKernel = char* (*)(const char*, const char*, char*, char);
+
+
+/// Number of characters in an ASCII case range.
+///
+const char letters(26);
+
+
+/// Flip the case of every character in the range [lo, lo + 26).
+///
+/// @param first first input position
+/// @param last last input position (exclusive)
+/// @param out first output position
+/// @param lo first character to convert ('A' or 'a')
+/// @return last output position (exclusive)
+char* flipcase_scalar(const char* first, const char* last, char* out, char lo) {
+    // This is branchless so that the compiler is free to vectorize it for
+    // platforms that do not have a hand-written kernel.
+    for (; first != last; ++first, ++out) {
+        const auto c(static_cast<unsigned char>(*first));
+        const auto flip(static_cast<unsigned char>(c - lo) < letters);
+        *out = static_cast<char>(c ^ (flip << 5));
+    }
+    return out;
+}
+
+
+#ifdef PYPP_SIMD_X86
+
+/// SSE2 implementation of flipcase_scalar().
+///
+char* flipcase_sse2(const char* first, const char* last, char* out, char lo) {
+    // Shift the target range to the bottom of the signed char range so that
+    // a single signed comparison can be used as a range check.
+    const auto offset(_mm_set1_epi8(static_cast<char>(0x80 - lo)));
+    const auto limit(_mm_set1_epi8(static_cast<char>(-0x80 + letters)));
+    const auto bit(_mm_set1_epi8(0x20));
+    static const auto width(sizeof(__m128i));
+    for (; static_cast<size_t>(last - first) >= width; first += width, out += width) {
+        const auto chars(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first)));
+        const auto match(_mm_cmplt_epi8(_mm_add_epi8(chars, offset), limit));
+        const auto result(_mm_xor_si128(chars, _mm_and_si128(match, bit)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), result);
+    }
+    return flipcase_scalar(first, last, out, lo);
+}
+
+
+/// AVX2 implementation of flipcase_scalar().
+///
+__attribute__((target("avx2")))
+char* flipcase_avx2(const char* first, const char* last, char* out, char lo) {
+    const auto offset(_mm256_set1_epi8(static_cast<char>(0x80 - lo)));
+    const auto limit(_mm256_set1_epi8(static_cast<char>(-0x80 + letters)));
+    const auto bit(_mm256_set1_epi8(0x20));
+    static const auto width(sizeof(__m256i));
+    for (; static_cast<size_t>(last - first) >= width; first += width, out += width) {
+        const auto chars(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first)));
+        const auto match(_mm256_cmpgt_epi8(limit, _mm256_add_epi8(chars, offset)));
+        const auto result(_mm256_xor_si256(chars, _mm256_and_si256(match, bit)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), result);
+    }
+    return flipcase_sse2(first, last, out, lo);
+}
+
+#endif  // PYPP_SIMD_X86
+
+
+/// Function signature for substring search kernels.
+///
+using FindKernel = const char* (*)(const char*, const char*, const char*, size_t);
+
+
+/// Substrings at least this long are searched for with find_horspool().
+///
+/// Shorter substrings are searched for by the vectorized first/last byte
+/// filter, which is faster than skipping unless the skips are long.
+///
+const size_t horspool_min(512);
+
+
+/// Find a substring using the Boyer-Moore-Horspool algorithm.
+///
+/// @param first first position of the string to search
+/// @param last last position of the string to search (exclusive)
+/// @param sub substring to find
+/// @param len substring length (must be non-zero)
+/// @return position of the match, or nullptr if not found
+const char* find_horspool(const char* first, const char* last, const char* sub, size_t len) {
+    size_t skip[256];
+    std::fill(std::begin(skip), std::end(skip), len);
+    for (size_t pos(0); pos < len - 1; ++pos) {
+        skip[static_cast<unsigned char>(sub[pos])] = len - 1 - pos;
+    }
+    const auto tail(sub[len - 1]);
+    for (auto pos(first); static_cast<size_t>(last - pos) >= len;) {
+        const auto c(pos[len - 1]);
+        if (c == tail and std::memcmp(pos, sub, len - 1) == 0) {
+            return pos;
+        }
+        pos += skip[static_cast<unsigned char>(c)];
+    }
+    return nullptr;
+}
+
+
+/// Find the last occurrence of a substring using the Horspool algorithm.
+///
+/// This is the mirror image of find_horspool().
+///
+/// @param first first position of the string to search
+/// @param last last position of the string to search (exclusive)
+/// @param sub substring to find
+/// @param len substring length (must be non-zero)
+/// @return position of the match, or nullptr if not found
+const char* rfind_horspool(const char* first, const char* last, const char* sub, size_t len) {
+    size_t skip[256];
+    std::fill(std::begin(skip), std::end(skip), len);
+    for (size_t pos(len - 1); pos > 0; --pos) {
+        skip[static_cast<unsigned char>(sub[pos])] = pos;
+    }
+    const auto head(sub[0]);
+    for (auto pos(last - len); pos >= first;) {
+        const auto c(*pos);
+        if (c == head and std::memcmp(pos + 1, sub + 1, len - 1) == 0) {
+            return pos;
+        }
+        if (static_cast<size_t>(pos - first) < skip[static_cast<unsigned char>(c)]) {
+            break;
+        }
+        pos -= skip[static_cast<unsigned char>(c)];
+    }
+    return nullptr;
+}
+
+
+/// Find a substring by comparing its first and last characters.
+///
+/// This is the scalar version of the vectorized kernels, which is used for
+/// the remainder of the string that does not fill a vector.
+///
+/// @param first first position of the string to search
+/// @param last last position of the string to search (exclusive)
+/// @param sub substring to find
+/// @param len substring length (must be non-zero)
+/// @return position of the match, or nullptr if not found
+const char* find_scalar(const char* first, const char* last, const char* sub, size_t len) {
+    for (auto pos(first); static_cast<size_t>(last - pos) >= len; ++pos) {
+        pos = static_cast<const char*>(std::memchr(pos, sub[0], last - pos - len + 1));
+        if (not pos) {
+            break;
+        }
+        if (pos[len - 1] == sub[len - 1] and std::memcmp(pos + 1, sub + 1, len - 1) == 0) {
+            return pos;
+        }
+    }
+    return nullptr;
+}
+
+
+#ifdef PYPP_SIMD_X86
+
+/// Check each set bit of a candidate mask for a substring match.
+///
+/// @param pos string position corresponding to the lowest bit
+/// @param mask candidate positions
+/// @param sub substring to find
+/// @param len substring length
+/// @return position of the match, or nullptr if not found
+inline const char* check_mask(const char* pos, uint32_t mask, const char* sub, size_t len) {
+    // The first and last characters are already known to match.
+    while (mask != 0) {
+        const auto match(pos + __builtin_ctz(mask));
+        if (std::memcmp(match + 1, sub + 1, len - 1) == 0) {
+            return match;
+        }
+        mask &= mask - 1;
+    }
+    return nullptr;
+}
+
+
+/// SSE2 implementation of find_scalar().
+///
+/// This is based on the "generic SIMD" algorithm, which compares blocks of
+/// the string to the first and last characters of the substring at the same
+/// time. Only positions where both match are compared in full.
+///
+const char* find_sse2(const char* first, const char* last, const char* sub, size_t len) {
+    const auto head(_mm_set1_epi8(sub[0]));
+    const auto tail(_mm_set1_epi8(sub[len - 1]));
+    static const auto width(sizeof(__m128i));
+    auto pos(first);
+    for (; static_cast<size_t>(last - pos) >= width + len - 1; pos += width) {
+        const auto block_head(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos)));
+        const auto block_tail(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos + len - 1)));
+        const auto match(_mm_and_si128(_mm_cmpeq_epi8(block_head, head), _mm_cmpeq_epi8(block_tail, tail)));
+        const auto mask(static_cast<uint32_t>(_mm_movemask_epi8(match)));
+        const auto found(check_mask(pos, mask, sub, len));
+        if (found) {
+            return found;
+        }
+    }
+    return find_scalar(pos, last, sub, len);
+}
+
+
+/// AVX2 implementation of find_scalar().
+///
+__attribute__((target("avx2")))
+const char* find_avx2(const char* first, const char* last, const char* sub, size_t len) {
+    const auto head(_mm256_set1_epi8(sub[0]));
+    const auto tail(_mm256_set1_epi8(sub[len - 1]));
+    static const auto width(sizeof(__m256i));
+    auto pos(first);
+    for (; static_cast<size_t>(last - pos) >= width + len - 1; pos += width) {
+        const auto block_head(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos)));
+        const auto block_tail(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos + len - 1)));
+        const auto match(_mm256_and_si256(_mm256_cmpeq_epi8(block_head, head), _mm256_cmpeq_epi8(block_tail, tail)));
+        const auto mask(static_cast<uint32_t>(_mm256_movemask_epi8(match)));
+        const auto found(check_mask(pos, mask, sub, len));
+        if (found) {
+            return found;
+        }
+    }
+    return find_sse2(pos, last, sub, len);
+}
+
+
+/// Find the last occurrence of a substring using SSE2.
+///
+/// This is the mirror image of find_sse2().
+///
+const char* rfind_sse2(const char* first, const char* last, const char* sub, size_t len) {
+    const auto head(_mm_set1_epi8(sub[0]));
+    const auto tail(_mm_set1_epi8(sub[len - 1]));
+    static const auto width(sizeof(__m128i));
+    auto end(last - len + 1);  // one past the last candidate position
+    for (; static_cast<size_t>(end - first) >= width; end -= width) {
+        const auto pos(end - width);
+        const auto block_head(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos)));
+        const auto block_tail(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos + len - 1)));
+        const auto match(_mm_and_si128(_mm_cmpeq_epi8(block_head, head), _mm_cmpeq_epi8(block_tail, tail)));
+        auto mask(static_cast<uint32_t>(_mm_movemask_epi8(match)));
+        while (mask != 0) {
+            // Check candidates from highest to lowest position.
+            const auto bit(31 - __builtin_clz(mask));
+            if (std::memcmp(pos + bit + 1, sub + 1, len - 1) == 0) {
+                return pos + bit;
+            }
+            mask &= ~(1u << bit);
+        }
+    }
+    for (auto pos(end); pos != first;) {
+        --pos;
+        if (pos[0] == sub[0] and std::memcmp(pos + 1, sub + 1, len - 1) == 0) {
+            return pos;
+        }
+    }
+    return nullptr;
+}
+
+#endif  // PYPP_SIMD_X86
+
+
+/// Function signature for character set scanning kernels.
+///
+using SpanKernel = const char* (*)(const char*, const char*, const uint64_t*);
+
+
+/// Test if a character is in a set.
+///
+/// @param set 256-bit bitmap of set members
+/// @param c character to test
+/// @return true if the character is a member
+inline bool member(const uint64_t* set, char c) {
+    const auto byte(static_cast<unsigned char>(c));
+    return (set[byte >> 6] >> (byte & 63)) & 1;
+}
+
+
+/// Find the first character that is not in a set.
+///
+/// @param first first position
+/// @param last last position (exclusive)
+/// @param set 256-bit bitmap of set members
+/// @return first position not in the set, or `last`
+const char* span_scalar(const char* first, const char* last, const uint64_t* set) {
+    while (first != last and member(set, *first)) {
+        ++first;
+    }
+    return first;
+}
+
+
+/// Find the end of a range with trailing set members removed.
+///
+/// @param first first position
+/// @param last last position (exclusive)
+/// @param set 256-bit bitmap of set members
+/// @return position after the last character not in the set, or `first`
+const char* rspan_scalar(const char* first, const char* last, const uint64_t* set) {
+    while (last != first and member(set, *(last - 1))) {
+        --last;
+    }
+    return last;
+}
+
+
+#ifdef PYPP_SIMD_X86
+
+/// Lookup tables for vectorized set membership tests.
+///
+/// A byte is split into a low nibble and a high nibble. The low nibble indexes
+/// a 16-entry table whose entries are bitmaps over the high nibble, and the
+/// high nibble selects the bit to test. Two tables are needed because each
+/// entry only has 8 bits: `lo` covers high nibbles 0-7, and `hi` covers high
+/// nibbles 8-F.
+///
+struct SetTables {
+    __m256i lo;
+    __m256i hi;
+};
+
+
+/// Create the lookup tables for a character set.
+///
+/// @param set 256-bit bitmap of set members
+/// @return lookup tables
+__attribute__((target("avx2")))
+SetTables set_tables(const uint64_t* set) {
+    alignas(16) uint8_t lo[16] = {0};
+    alignas(16) uint8_t hi[16] = {0};
+    for (unsigned word(0); word < 4; ++word) {
+        for (auto bits(set[word]); bits != 0; bits &= bits - 1) {
+            const auto byte(word * 64 + __builtin_ctzll(bits));
+            auto& table(byte < 128 ? lo : hi);
+            table[byte & 0x0f] |= 1 << ((byte >> 4) & 0x07);
+        }
+    }
+    // VPSHUFB operates on each 128-bit lane separately, so the tables are
+    // duplicated in both lanes.
+    return {
+        _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(lo))),
+        _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(hi))),
+    };
+}
+
+
+/// Get a mask of the characters in a block that are not in a set.
+///
+/// @param tables set lookup tables
+/// @param chars block of characters
+/// @return bit mask with one bit per character
+__attribute__((target("avx2")))
+inline uint32_t nonmembers(const SetTables& tables, __m256i chars) {
+    const auto nibble(_mm256_set1_epi8(0x0f));
+    const auto bits(_mm256_setr_epi8(
+        1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+        1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128));
+    const auto lo(_mm256_and_si256(chars, nibble));
+    const auto hi(_mm256_and_si256(_mm256_srli_epi16(chars, 4), nibble));
+    // BLENDV selects by the high bit of each byte, which is the high bit of
+    // the high nibble.
+    const auto row(_mm256_blendv_epi8(
+        _mm256_shuffle_epi8(tables.lo, lo), _mm256_shuffle_epi8(tables.hi, lo), chars));
+    const auto match(_mm256_and_si256(row, _mm256_shuffle_epi8(bits, hi)));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(match, _mm256_setzero_si256())));
+}
+
+
+/// AVX2 implementation of span_scalar().
+///
+__attribute__((target("avx2")))
+const char* span_avx2(const char* first, const char* last, const uint64_t* set) {
+    static const auto width(sizeof(__m256i));
+    if (static_cast<size_t>(last - first) < width or not member(set, *first)) {
+        // Don't pay for the table setup if the result is close to the start.
+        return span_scalar(first, last, set);
+    }
+    const auto tables(set_tables(set));
+    for (; static_cast<size_t>(last - first) >= width; first += width) {
+        const auto chars(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first)));
+        const auto mask(nonmembers(tables, chars));
+        if (mask != 0) {
+            return first + __builtin_ctz(mask);
+        }
+    }
+    return span_scalar(first, last, set);
+}
+
+
+/// AVX2 implementation of rspan_scalar().
+///
+__attribute__((target("avx2")))
+const char* rspan_avx2(const char* first, const char* last, const uint64_t* set) {
+    static const auto width(sizeof(__m256i));
+    if (static_cast<size_t>(last - first) < width or not member(set, *(last - 1))) {
+        return rspan_scalar(first, last, set);
+    }
+    const auto tables(set_tables(set));
+    for (; static_cast<size_t>(last - first) >= width; last -= width) {
+        const auto chars(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(last - width)));
+        const auto mask(nonmembers(tables, chars));
+        if (mask != 0) {
+            return last - __builtin_clz(mask);
+        }
+    }
+    return rspan_scalar(first, last, set);
+}
+
+#endif  // PYPP_SIMD_X86
+
+
+/// Select the best character set scanning kernels for this CPU.
+///
+/// @return forward and reverse kernel functions
+std::pair<SpanKernel, SpanKernel> span_kernels() {
+#ifdef PYPP_SIMD_X86
+    static const auto avx2(__builtin_cpu_supports("avx2"));
+    static const std::pair<SpanKernel, SpanKernel> kernels(
+        avx2 ? span_avx2 : span_scalar, avx2 ? rspan_avx2 : rspan_scalar);
+#else
+    static const std::pair<SpanKernel, SpanKernel> kernels(span_scalar, rspan_scalar);
+#endif
+    return kernels;
+}
+
+
+/// Function signature for line ending search kernels.
+///
+using EolKernel = const char* (*)(const char*, const char*);
+
+
+/// Find the first line ending character.
+///
+/// @param first first position
+/// @param last last position (exclusive)
+/// @return position of the line ending, or `last` if not found
+const char* find_eol_scalar(const char* first, const char* last) {
+    while (first != last and *first != '\n' and *first != '\r') {
+        ++first;
+    }
+    return first;
+}
+
+
+#ifdef PYPP_SIMD_X86
+
+/// SSE2 implementation of find_eol_scalar().
+///
+const char* find_eol_sse2(const char* first, const char* last) {
+    const auto lf(_mm_set1_epi8('\n'));
+    const auto cr(_mm_set1_epi8('\r'));
+    static const auto width(sizeof(__m128i));
+    for (; static_cast<size_t>(last - first) >= width; first += width) {
+        const auto chars(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first)));
+        const auto match(_mm_or_si128(_mm_cmpeq_epi8(chars, lf), _mm_cmpeq_epi8(chars, cr)));
+        const auto mask(static_cast<uint32_t>(_mm_movemask_epi8(match)));
+        if (mask != 0) {
+            return first + __builtin_ctz(mask);
+        }
+    }
+    return find_eol_scalar(first, last);
+}
+
+
+/// AVX2 implementation of find_eol_scalar().
+///
+__attribute__((target("avx2")))
+const char* find_eol_avx2(const char* first, const char* last) {
+    const auto lf(_mm256_set1_epi8('\n'));
+    const auto cr(_mm256_set1_epi8('\r'));
+    static const auto width(sizeof(__m256i));
+    for (; static_cast<size_t>(last - first) >= width; first += width) {
+        const auto chars(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first)));
+        const auto match(_mm256_or_si256(_mm256_cmpeq_epi8(chars, lf), _mm256_cmpeq_epi8(chars, cr)));
+        const auto mask(static_cast<uint32_t>(_mm256_movemask_epi8(match)));
+        if (mask != 0) {
+            return first + __builtin_ctz(mask);
+        }
+    }
+    return find_eol_sse2(first, last);
+}
+
+#endif  // PYPP_SIMD_X86
+
+
+/// Select the best line ending search kernel for this CPU.
+///
+/// @return kernel function
+EolKernel find_eol_kernel() {
+#ifdef PYPP_SIMD_X86
+    static const EolKernel kernel(__builtin_cpu_supports("avx2") ? find_eol_avx2 : find_eol_sse2);
+#else
+    static const EolKernel kernel(find_eol_scalar);
+#endif
+    return kernel;
+}
+
+
+/// Select the best substring search kernel for this CPU.
+///
+/// @return kernel function
+FindKernel find_kernel() {
+#ifdef PYPP_SIMD_X86
+    static const FindKernel kernel(__builtin_cpu_supports("avx2") ? find_avx2 : find_sse2);
+#else
+    static const FindKernel kernel(find_scalar);
+#endif
+    return kernel;
+}
+
+
+/// Select the best case conversion kernel for this CPU.
+///
+/// @return kernel function
+CaseKernel flipcase_kernel() {
+#ifdef PYPP_SIMD_X86
+    static const CaseKernel kernel(__builtin_cpu_supports("avx2") ? flipcase_avx2 : flipcase_sse2);
+#else
+    static const CaseKernel kernel(flipcase_scalar);
+#endif
+    return kernel;
+}
+
+}  // internal linkage
+
+
+char* pypp::simd::lower(const char* first, const char* last, char* out) {
+    return flipcase_kernel()(first, last, out, 'A');
+}
+
+
+char* pypp::simd::upper(const char* first, const char* last, char* out) {
+    return flipcase_kernel()(first, last, out, 'a');
+}
+
+
+const char* pypp::simd::find(const char* first, const char* last, const char* sub_first, const char* sub_last) {
+    const auto len(static_cast<size_t>(sub_last - sub_first));
+    if (len == 0) {
+        return first;
+    }
+    if (len > static_cast<size_t>(last - first)) {
+        return nullptr;
+    }
+    if (len == 1) {
+        return static_cast<const char*>(std::memchr(first, *sub_first, last - first));
+    }
+    if (len >= horspool_min) {
+        return find_horspool(first, last, sub_first, len);
+    }
+    return find_kernel()(first, last, sub_first, len);
+}
+
+
+const char* pypp::simd::rfind(const char* first, const char* last, const char* sub_first, const char* sub_last) {
+    const auto len(static_cast<size_t>(sub_last - sub_first));
+    if (len == 0) {
+        return last;
+    }
+    if (len > static_cast<size_t>(last - first)) {
+        return nullptr;
+    }
+    if (len >= horspool_min) {
+        return rfind_horspool(first, last, sub_first, len);
+    }
+#ifdef PYPP_SIMD_X86
+    return rfind_sse2(first, last, sub_first, len);
+#else
+    for (auto pos(last - len + 1); pos != first;) {
+        --pos;
+        if (pos[0] == sub_first[0] and std::memcmp(pos + 1, sub_first + 1, len - 1) == 0) {
+            return pos;
+        }
+    }
+    return nullptr;
+#endif
+}
+
+
+const char* pypp::simd::span(const char* first, const char* last, const std::uint64_t* set) {
+    return span_kernels().first(first, last, set);
+}
+
+
+const char* pypp::simd::rspan(const char* first, const char* last, const std::uint64_t* set) {
+    return span_kernels().second(first, last, set);
+}
+
+
+const char* pypp::simd::find_eol(const char* first, const char* last) {
+    return find_eol_kernel()(first, last);
+}
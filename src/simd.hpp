@@ -0,0 +1,91 @@
+/// Vectorized kernels shared by the library implementation.
+///
+/// This is not part of the public API. Each kernel has a portable scalar
+/// implementation, and x86 builds use SSE2 or AVX2 implementations, selected
+/// at runtime based on the capabilities of the host CPU where applicable.
+///
+#ifndef PYPP_SIMD_HPP
+#define PYPP_SIMD_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace pypp { namespace simd {
+
+/// Convert ASCII upper case characters to lower case.
+///
+/// Non-ASCII bytes are copied as-is. The output may be the same as the input
+/// for an in-place conversion, but the ranges must not otherwise overlap.
+///
+/// @param first first input position
+/// @param last last input position (exclusive)
+/// @param out first output position
+/// @return last output position (exclusive)
+char* lower(const char* first, const char* last, char* out);
+
+
+/// Convert ASCII lower case characters to upper case.
+///
+/// Non-ASCII bytes are copied as-is. The output may be the same as the input
+/// for an in-place conversion, but the ranges must not otherwise overlap.
+///
+/// @param first first input position
+/// @param last last input position (exclusive)
+/// @param out first output position
+/// @return last output position (exclusive)
+char* upper(const char* first, const char* last, char* out);
+
+
+/// Find the first occurrence of a substring.
+///
+/// An empty substring matches at the first position.
+///
+/// @param first first position of the string to search
+/// @param last last position of the string to search (exclusive)
+/// @param sub_first first position of the substring
+/// @param sub_last last position of the substring (exclusive)
+/// @return position of the match, or nullptr if not found
+const char* find(const char* first, const char* last, const char* sub_first, const char* sub_last);
+
+
+/// Find the last occurrence of a substring.
+///
+/// An empty substring matches at the last position.
+///
+/// @param first first position of the string to search
+/// @param last last position of the string to search (exclusive)
+/// @param sub_first first position of the substring
+/// @param sub_last last position of the substring (exclusive)
+/// @return position of the match, or nullptr if not found
+const char* rfind(const char* first, const char* last, const char* sub_first, const char* sub_last);
+
+
+/// Find the first character that is not in a set.
+///
+/// @param first first position
+/// @param last last position (exclusive)
+/// @param set 256-bit bitmap of set members
+/// @return first position not in the set, or `last`
+const char* span(const char* first, const char* last, const std::uint64_t* set);
+
+
+/// Find the end of a range with trailing members of a set removed.
+///
+/// @param first first position
+/// @param last last position (exclusive)
+/// @param set 256-bit bitmap of set members
+/// @return position after the last character not in the set, or `first`
+const char* rspan(const char* first, const char* last, const std::uint64_t* set);
+
+
+/// Find the first line ending character (`\n` or `\r`).
+///
+/// @param first first position
+/// @param last last position (exclusive)
+/// @return position of the line ending, or `last` if not found
+const char* find_eol(const char* first, const char* last);
+
+}}  // namespace pypp::simd
+
+#endif  // PYPP_SIMD_HPP
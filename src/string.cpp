@@ -1,72 +1,191 @@
 /// Implementation of the string module.
 ///
 #include <cmath>
-#include <locale>
+#include <cstring>
 #include <algorithm>
+#include <deque>
 #include <iterator>
 #include <ios>
 #include <stdexcept>
 #include "pypp/func.hpp"
 #include "pypp/string.hpp"
+#include "simd.hpp"
 
 
 using std::ceil;
+using std::copy;
+using std::deque;
 using std::distance;
-using std::find;
+using std::find_if;
+using std::find_if_not;
 using std::floor;
 using std::invalid_argument;
-using std::locale;
 using std::max;
+using std::min;
+using std::move;
 using std::next;
+using std::pair;
+using std::prev;
+using std::reverse;
+using std::reverse_iterator;
 using std::string;
-using std::tolower;
-using std::transform;
 using std::vector;
 
 using namespace pypp;
+using str::StringView;
 
 
 const string str::whitespace(" \t\n\v\f\r");  // "C" locale
 
 
+namespace {
+
+/// Determine if a character is whitespace.
+///
+/// @param c input char
+/// @return true for whitespace
+bool is_whitespace(char c) {
+    // Equivalent to searching `whitespace` but much faster.
+    return c == ' ' or (c >= '\t' and c <= '\r');
+}
+
+
+/// Find the end of a range with trailing whitespace removed.
+///
+/// @param first first position
+/// @param last last position (exclusive)
+/// @return new last position (exclusive)
+const char* rstrip_end(const char* first, const char* last) {
+    while (last != first and is_whitespace(*prev(last))) {
+        --last;
+    }
+    return last;
+}
+
+
+
+/// Find a substring.
+///
+/// @param str string to search
+/// @param sub substring to find
+/// @param pos starting position
+/// @return position of the substring, or npos if not found
+size_t find_from(StringView str, StringView sub, size_t pos=0) {
+    const auto found(simd::find(str.begin() + pos, str.end(), sub.begin(), sub.end()));
+    return found ? found - str.begin() : string::npos;
+}
+
+}  // internal linkage
+
+
 char str::lower(char c) {
-    return tolower(c, locale());
+    return static_cast<unsigned char>(c - 'A') < 26 ? c ^ 0x20 : c;
 }
 
 
 string str::lower(string str) {
-    static const auto lambda([](char c){ return lower(c); });
-    transform(str.begin(), str.end(), str.begin(), lambda);
+    lower(&str[0], &str[0] + str.size());
     return str;
 }
 
 
+void str::lower(char* first, char* last) {
+    simd::lower(first, last, first);
+    return;
+}
+
+
+char* str::lower(const char* first, const char* last, char* out) {
+    return simd::lower(first, last, out);
+}
+
+
 char str::upper(char c) {
-    return toupper(c, locale());
+    return static_cast<unsigned char>(c - 'a') < 26 ? c ^ 0x20 : c;
 }
 
 
 string str::upper(string str) {
-    static const auto lambda([](char c){ return upper(c); });
-    transform(str.begin(), str.end(), str.begin(), lambda);
+    upper(&str[0], &str[0] + str.size());
     return str;
 }
 
 
+void str::upper(char* first, char* last) {
+    simd::upper(first, last, first);
+    return;
+}
+
+
+char* str::upper(const char* first, const char* last, char* out) {
+    return simd::upper(first, last, out);
+}
+
+
+string str::lstrip(const string& str, const CharSet& chars) {
+    const auto first(str.data());
+    const auto last(first + str.size());
+    return string(simd::span(first, last, chars.bitmap()), last);
+}
+
+
 string str::lstrip(const string& str, const string& chars) {
-    const auto pos(str.find_first_not_of(chars));
-    return pos == string::npos ? "" : str.substr(pos);
+    return lstrip(str, CharSet(chars));
+}
+
+
+string str::lstrip(string&& str, const CharSet& chars) {
+    str.erase(0, simd::span(str.data(), str.data() + str.size(), chars.bitmap()) - str.data());
+    return move(str);
+}
+
+
+string str::lstrip(string&& str, const string& chars) {
+    return lstrip(move(str), CharSet(chars));
+}
+
+
+string str::rstrip(const string& str, const CharSet& chars) {
+    const auto first(str.data());
+    return string(first, simd::rspan(first, first + str.size(), chars.bitmap()));
 }
 
 
 string str::rstrip(const string& str, const string& chars) {
-    const auto pos(str.find_last_not_of(chars));
-    return pos == string::npos ? "" : str.substr(0, pos + 1);
+    return rstrip(str, CharSet(chars));
+}
+
+
+string str::rstrip(string&& str, const CharSet& chars) {
+    str.resize(simd::rspan(str.data(), str.data() + str.size(), chars.bitmap()) - str.data());
+    return move(str);
+}
+
+
+string str::rstrip(string&& str, const string& chars) {
+    return rstrip(move(str), CharSet(chars));
+}
+
+
+string str::strip(const string& str, const CharSet& chars) {
+    // Find both ends first so that only the result is allocated.
+    const auto first(simd::span(str.data(), str.data() + str.size(), chars.bitmap()));
+    return string(first, simd::rspan(first, str.data() + str.size(), chars.bitmap()));
 }
 
 
 string str::strip(const string& str, const string& chars) {
-    return rstrip(lstrip(str, chars), chars);
+    return strip(str, CharSet(chars));
+}
+
+
+string str::strip(string&& str, const CharSet& chars) {
+    return lstrip(rstrip(move(str), chars), chars);
+}
+
+
+string str::strip(string&& str, const string& chars) {
+    return strip(move(str), CharSet(chars));
 }
 
 
@@ -75,110 +194,260 @@ string str::join(const vector<string>& items, const string& sep) {
     // of items that contain the separator, e.g. joining "abc" and "d,ef," will
     // produce "abc,d,ef,". This means that join() and split() are not strict
     // inverses of each other unless a distinct separator is used.
-    string joined(items.front());
-    for (auto iter(next(items.cbegin())); iter != items.cend(); ++iter) {
-        // Skip first element to avoid leading delimiter.
-        joined += sep + *iter;
-    }
-    return joined;
+    return join(items.begin(), items.end(), sep);
 }
 
 
 string str::join(const vector<string>& items, char sep) {
-    return join(items, string(1, sep));
+    return join(items.begin(), items.end(), StringView(&sep, 1));
 }
 
 
 vector<string> str::split(const string& str, ssize_t maxsplit) {
     vector<string> items;
-    auto beg(str.find_first_not_of(whitespace));
-    while (beg <= str.size()) {
-        auto end(str.size());
-        if (maxsplit < 0 or items.size() < static_cast<size_t>(maxsplit)) {
-            // Continue splitting.
-            end = str.find_first_of(whitespace, beg);
-            if (end == string::npos) {
-                end = str.size();
-            }
-        }
-        items.emplace_back(str.substr(beg, end - beg));
-        beg = str.find_first_not_of(whitespace, end);
+    for (const auto item: isplit(str, maxsplit)) {
+        items.emplace_back(item.data(), item.size());
     }
     return items;
 }
 
 
 vector<string> str::split(const string& str, const string& sep, ssize_t maxsplit) {
-    if (sep.empty()) {
-        throw invalid_argument("empty separator");
-    }
     vector<string> items;
-    string::size_type beg(0);
-    while (beg <= str.length()) {
-        string::size_type end(str.size());
-        if (maxsplit < 0 or items.size() < static_cast<size_t>(maxsplit)) {
-            // Continue splitting.
-            end = str.find(sep, beg);
-            if (end == string::npos) {
-                end = str.length();
-            }
-        }
-        items.emplace_back(str.substr(beg, end - beg));
-        beg = end + sep.length();
+    for (const auto item: isplit(str, sep, maxsplit)) {
+        items.emplace_back(item.data(), item.size());
     }
     return items;
 }
 
 
 vector<string> str::rsplit(const string& str, ssize_t maxsplit) {
-    const auto rstrip_len = [str](string::size_type end) {
-        // Calculate the length of the string that would be returned by
-        // rstrip(str.substr(len)).
-        const auto pos(end != string::npos ? end - 1 : string::npos);
-        const auto last(str.find_last_not_of(whitespace, pos));
-        return last == string::npos ? 0 : last + 1;
-    };
+    // Items are generated from right to left, so reverse them at the end
+    // instead of inserting each new item at the front of the sequence.
     vector<string> items;
-    auto end(rstrip_len(string::npos));
-    while (end > 0) {
-        // Split the string from right to left such that each new item becomes
-        // the first item in the sequence.
-        const auto split(maxsplit < 0 or items.size() < static_cast<size_t>(maxsplit));
-        if (not split) {
-            // Consume the remainder of the string as the first item.
-            items.insert(items.begin(), str.substr(0, end));
-            break;
-        }
-        const auto pos(str.find_last_of(whitespace, end - 1));
-        const auto beg(pos != string::npos ? pos + 1 : 0);
-        items.insert(items.begin(), str.substr(beg, end - beg));
-        end = rstrip_len(beg);
+    for (const auto item: irsplit(str, maxsplit)) {
+        items.emplace_back(item.data(), item.size());
     }
+    reverse(items.begin(), items.end());
     return items;
 }
 
 
 vector<string> str::rsplit(const string& str, const string& sep, ssize_t maxsplit) {
+    vector<string> items;
+    for (const auto item: irsplit(str, sep, maxsplit)) {
+        items.emplace_back(item.data(), item.size());
+    }
+    reverse(items.begin(), items.end());
+    return items;
+}
+
+
+str::SplitGenerator::SplitGenerator(StringView str, string sep, ssize_t maxsplit):
+    str_(str), sep_(move(sep)), maxsplit_(maxsplit) {
+    if (sep_.empty()) {
+        // Leading whitespace is ignored.
+        beg_ = find_if_not(str_.begin(), str_.end(), is_whitespace) - str_.begin();
+    }
+    find();
+}
+
+
+bool str::SplitGenerator::active() const {
+    return beg_ <= str_.size();
+}
+
+
+StringView str::SplitGenerator::value() const {
+    return {str_.data() + beg_, end_ - beg_};
+}
+
+
+void str::SplitGenerator::next() {
+    ++count_;
+    if (end_ == str_.size()) {
+        // The last item has been consumed.
+        beg_ = StringView::npos;
+        return;
+    }
+    if (sep_.empty()) {
+        beg_ = find_if_not(str_.begin() + end_, str_.end(), is_whitespace) - str_.begin();
+    }
+    else {
+        beg_ = end_ + sep_.size();
+    }
+    find();
+    return;
+}
+
+
+void str::SplitGenerator::find() {
+    if (sep_.empty() and beg_ == str_.size()) {
+        // Trailing whitespace does not generate an empty item.
+        beg_ = StringView::npos;
+        return;
+    }
+    end_ = str_.size();
+    if (maxsplit_ < 0 or count_ < maxsplit_) {
+        // Continue splitting.
+        const auto first(str_.begin() + beg_);
+        if (sep_.empty()) {
+            end_ = find_if(first, str_.end(), is_whitespace) - str_.begin();
+        }
+        else {
+            const auto pos(simd::find(first, str_.end(), sep_.data(), sep_.data() + sep_.size()));
+            end_ = pos ? pos - str_.begin() : str_.size();
+        }
+    }
+    return;
+}
+
+
+str::RSplitGenerator::RSplitGenerator(StringView str, string sep, ssize_t maxsplit):
+    str_(str), sep_(move(sep)), maxsplit_(maxsplit), end_(str.size()) {
+    if (sep_.empty()) {
+        // Trailing whitespace is ignored.
+        end_ = rstrip_end(str_.begin(), str_.begin() + end_) - str_.begin();
+    }
+    find();
+}
+
+
+bool str::RSplitGenerator::active() const {
+    return beg_ != StringView::npos;
+}
+
+
+StringView str::RSplitGenerator::value() const {
+    return {str_.data() + beg_, end_ - beg_};
+}
+
+
+void str::RSplitGenerator::next() {
+    ++count_;
+    if (last_) {
+        // The first item has been consumed.
+        beg_ = StringView::npos;
+        return;
+    }
+    if (sep_.empty()) {
+        end_ = rstrip_end(str_.begin(), str_.begin() + beg_) - str_.begin();
+    }
+    else {
+        end_ = beg_ - sep_.size();
+    }
+    find();
+    return;
+}
+
+
+void str::RSplitGenerator::find() {
+    if (sep_.empty() and end_ == 0) {
+        // Leading whitespace does not generate an empty item.
+        beg_ = StringView::npos;
+        return;
+    }
+    const auto first(str_.begin());
+    const auto last(first + end_);
+    beg_ = 0;
+    last_ = true;
+    if (maxsplit_ < 0 or count_ < maxsplit_) {
+        // Continue splitting.
+        if (sep_.empty()) {
+            const auto pos(find_if(reverse_iterator<const char*>(last), reverse_iterator<const char*>(first), is_whitespace));
+            beg_ = pos.base() - first;
+            last_ = beg_ == 0;
+        }
+        else {
+            const auto pos(simd::rfind(first, last, sep_.data(), sep_.data() + sep_.size()));
+            if (pos) {
+                beg_ = pos - first + sep_.size();
+                last_ = false;
+            }
+        }
+    }
+    return;
+}
+
+
+str::SplitGenerator str::isplit(StringView str, ssize_t maxsplit) {
+    return {str, "", maxsplit};
+}
+
+
+str::SplitGenerator str::isplit(StringView str, const string& sep, ssize_t maxsplit) {
     if (sep.empty()) {
         throw invalid_argument("empty separator");
     }
-    vector<string> items;
-    auto end(str.size());
-    while (true) {
-        // Split the string from right to left such that each new item becomes
-        // the first item in the sequence.
-        const auto split(maxsplit < 0 or items.size() < static_cast<size_t>(maxsplit));
-        const auto pos(str.rfind(sep, end - sep.size()));
-        if (not split or end == 0 or pos == string::npos) {
-            // Consume the remainder of the string as the first item.
-            items.insert(items.begin(), str.substr(0, end));
-            break;
+    return {str, sep, maxsplit};
+}
+
+
+str::RSplitGenerator str::irsplit(StringView str, ssize_t maxsplit) {
+    return {str, "", maxsplit};
+}
+
+
+str::RSplitGenerator str::irsplit(StringView str, const string& sep, ssize_t maxsplit) {
+    if (sep.empty()) {
+        throw invalid_argument("empty separator");
+    }
+    return {str, sep, maxsplit};
+}
+
+
+vector<string> str::splitlines(const string& str, bool keepends) {
+    vector<string> lines;
+    for (const auto line: isplitlines(str, keepends)) {
+        lines.emplace_back(line.data(), line.size());
+    }
+    return lines;
+}
+
+
+str::LineGenerator::LineGenerator(StringView str, bool keepends):
+    str_(str), keepends_(keepends) {
+    find();
+}
+
+
+bool str::LineGenerator::active() const {
+    return beg_ < str_.size();
+}
+
+
+StringView str::LineGenerator::value() const {
+    return {str_.data() + beg_, (keepends_ ? eol_ : end_) - beg_};
+}
+
+
+void str::LineGenerator::next() {
+    beg_ = eol_;
+    find();
+    return;
+}
+
+
+void str::LineGenerator::find() {
+    if (beg_ >= str_.size()) {
+        // A trailing line ending does not generate an empty line.
+        return;
+    }
+    end_ = simd::find_eol(str_.begin() + beg_, str_.end()) - str_.begin();
+    eol_ = end_;
+    if (eol_ < str_.size()) {
+        // Consume the line ending, treating "\r\n" as a single ending.
+        ++eol_;
+        if (str_[end_] == '\r' and eol_ < str_.size() and str_[eol_] == '\n') {
+            ++eol_;
         }
-        const auto beg(pos + sep.size());
-        items.insert(items.begin(), str.substr(beg, end - beg));
-        end = pos;
     }
-    return items;
+    return;
+}
+
+
+str::LineGenerator str::isplitlines(StringView str, bool keepends) {
+    return {str, keepends};
 }
 
 
@@ -212,30 +481,287 @@ bool str::endswith(const string& str, char suffix) {
 }
 
 
+ssize_t str::find(StringView str, StringView sub) {
+    if (sub.empty()) {
+        return 0;  // simd::find() cannot tell a match in a null view from no match
+    }
+    const auto pos(find_from(str, sub));
+    return pos == string::npos ? -1 : static_cast<ssize_t>(pos);
+}
+
+
+ssize_t str::rfind(StringView str, StringView sub) {
+    if (sub.empty()) {
+        return static_cast<ssize_t>(str.size());
+    }
+    const auto pos(simd::rfind(str.begin(), str.end(), sub.begin(), sub.end()));
+    return pos ? pos - str.begin() : -1;
+}
+
+
+size_t str::index(StringView str, StringView sub) {
+    const auto pos(find(str, sub));
+    if (pos < 0) {
+        throw invalid_argument("substring not found");
+    }
+    return static_cast<size_t>(pos);
+}
+
+
+size_t str::rindex(StringView str, StringView sub) {
+    const auto pos(rfind(str, sub));
+    if (pos < 0) {
+        throw invalid_argument("substring not found");
+    }
+    return static_cast<size_t>(pos);
+}
+
+
+size_t str::count(StringView str, StringView sub) {
+    if (sub.empty()) {
+        return str.size() + 1;
+    }
+    size_t count(0);
+    for (auto pos(find_from(str, sub)); pos != string::npos; pos = find_from(str, sub, pos + sub.size())) {
+        ++count;
+    }
+    return count;
+}
+
+
+bool str::contains(StringView str, StringView sub) {
+    if (sub.empty()) {
+        return true;
+    }
+    return simd::find(str.begin(), str.end(), sub.begin(), sub.end()) != nullptr;
+}
+
+
 string str::replace(string str, const string& old, const string& sub, ssize_t maxcount) {
-    ssize_t count(0);
-    string::size_type pos(0);
-    if (not old.empty()) {
-        while (maxcount == -1 or count++ < maxcount) {
-            pos = str.find(old, pos);
-            if (pos == string::npos) {
-                break;
+    if (old.empty()) {
+        // An empty search string causes replace() to act like sub.join(str)
+        // with leading and trailing delimiters.
+        const auto count(maxcount < 0 ? str.size() + 1 : min(str.size() + 1, static_cast<size_t>(maxcount)));
+        string result;
+        result.reserve(str.size() + count * sub.size());
+        for (size_t pos(0); pos < count; ++pos) {
+            result += sub;
+            if (pos < str.size()) {
+                result += str[pos];
+            }
+        }
+        if (count < str.size()) {
+            result.append(str, count, string::npos);
+        }
+        return result;
+    }
+    const auto limit(maxcount < 0 ? string::npos : static_cast<size_t>(maxcount));
+    if (sub.size() == old.size()) {
+        // Replace in place without moving any other characters.
+        size_t count(0);
+        for (auto pos(find_from(str, old)); pos != string::npos and count < limit; pos = find_from(str, old, pos + old.size()), ++count) {
+            copy(sub.begin(), sub.end(), str.begin() + pos);
+        }
+        return str;
+    }
+    // Build the result in a single pass instead of repeatedly shifting the
+    // remainder of the string. The result is sized exactly if it will be
+    // longer than the input.
+    size_t size(str.size());
+    if (sub.size() > old.size()) {
+        size_t count(0);
+        for (auto pos(find_from(str, old)); pos != string::npos and count < limit; pos = find_from(str, old, pos + old.size())) {
+            ++count;
+        }
+        size += count * (sub.size() - old.size());
+    }
+    string result;
+    result.reserve(size);
+    size_t beg(0);
+    size_t count(0);
+    for (auto pos(find_from(str, old)); pos != string::npos and count < limit; pos = find_from(str, old, beg), ++count) {
+        result.append(str, beg, pos - beg);
+        result += sub;
+        beg = pos + old.size();
+    }
+    result.append(str, beg, string::npos);
+    return result;
+}
+
+
+str::Replacer::Replacer(const vector<pair<string, string>>& subs) {
+    // Map each byte that occurs in a pattern to its own equivalence class.
+    // All other bytes share class 0, which always leads to the fallback
+    // state. This keeps the transition table small. Classes are 16 bits so
+    // that a table with all 256 bytes in its patterns does not wrap to 0.
+    classes_.fill(0);
+    nclasses_ = 1;
+    for (const auto& item: subs) {
+        if (item.first.empty()) {
+            throw invalid_argument("empty pattern");
+        }
+        for (const auto c: item.first) {
+            auto& cls(classes_[static_cast<unsigned char>(c)]);
+            if (cls == 0) {
+                cls = static_cast<uint16_t>(nclasses_++);
             }
-            str.replace(pos, old.length(), sub);
-            pos += sub.length();
         }
     }
-    else {
-        // An empty search string causes replace() to act like sub.join(str)
-        // with leading and trailing delimiters.
-        while (maxcount == -1 or count++ < maxcount) {
-            str.insert(pos, sub);
-            pos += sub.length() + 1;
-            if (pos > str.length()) {
-                break;
+
+    // Build a trie of the patterns. A zero transition is undefined because
+    // the root state cannot be the target of a trie edge.
+    static const uint32_t root(0);
+    delta_.assign(nclasses_, root);
+    depth_.assign(1, 0);
+    match_.assign(1, -1);
+    for (const auto& item: subs) {
+        uint32_t state(root);
+        for (const auto c: item.first) {
+            const auto index(state * nclasses_ + classes_[static_cast<unsigned char>(c)]);
+            if (delta_[index] == root) {
+                delta_[index] = static_cast<uint32_t>(depth_.size());
+                delta_.resize(delta_.size() + nclasses_, root);
+                depth_.push_back(depth_[state] + 1);
+                match_.push_back(-1);
             }
+            state = delta_[index];
+        }
+        if (match_[state] < 0) {
+            match_[state] = static_cast<int32_t>(subs_.size());
+            subs_.emplace_back(item.second);
+            lengths_.emplace_back(item.first.size());
+        }
+        else {
+            subs_[match_[state]] = item.second;  // last one wins
+        }
+    }
+
+    // Convert the trie to a deterministic automaton in breadth-first order.
+    // Missing transitions are taken from the failure state, i.e. the longest
+    // proper suffix of the current state that is also in the trie. A state
+    // without its own match inherits the longest match of its failure state.
+    vector<uint32_t> fail(depth_.size(), root);
+    deque<uint32_t> queue;
+    for (size_t cls(0); cls < nclasses_; ++cls) {
+        if (delta_[cls] != root) {
+            queue.push_back(delta_[cls]);
+        }
+    }
+    while (not queue.empty()) {
+        const auto state(queue.front());
+        queue.pop_front();
+        if (match_[state] < 0) {
+            match_[state] = match_[fail[state]];
+        }
+        for (size_t cls(0); cls < nclasses_; ++cls) {
+            auto& target(delta_[state * nclasses_ + cls]);
+            const auto fallback(delta_[fail[state] * nclasses_ + cls]);
+            if (target != root) {
+                // This is a trie edge; everything else is still undefined.
+                fail[target] = fallback;
+                queue.push_back(target);
+            }
+            else {
+                target = fallback;
+            }
+        }
+    }
+    return;
+}
+
+
+string str::replace(const string& str, const Replacer& replacer, ssize_t maxcount) {
+    // Matches are found with an Aho-Corasick automaton. A match is not
+    // replaced until it is certain that no match starting at the same or an
+    // earlier position is still in progress, i.e. the current state is not
+    // deep enough to reach back to the start of the candidate match.
+    static const auto none(string::npos);
+    const auto limit(maxcount < 0 ? string::npos : static_cast<size_t>(maxcount));
+    const auto nclasses(replacer.nclasses_);
+    string result;
+    result.reserve(str.size());
+    size_t copied(0);  // end of input that has been copied to the result
+    size_t count(0);
+    size_t match_beg(none);
+    size_t match_len(0);
+    int32_t match_sub(-1);
+    uint32_t state(0);
+    size_t pos(0);
+    while (count < limit) {
+        if (pos == str.size() and match_beg == none) {
+            break;
+        }
+        if (pos < str.size()) {
+            const auto cls(replacer.classes_[static_cast<unsigned char>(str[pos++])]);
+            state = replacer.delta_[state * nclasses + cls];
+            const auto sub(replacer.match_[state]);
+            if (sub >= 0) {
+                // This is the longest match ending at this position, which
+                // is also the one that starts the earliest.
+                const auto len(replacer.lengths_[sub]);
+                const auto beg(pos - len);
+                if (match_beg == none or beg < match_beg or (beg == match_beg and len > match_len)) {
+                    match_beg = beg;
+                    match_len = len;
+                    match_sub = sub;
+                }
+            }
+            if (match_beg == none or pos - replacer.depth_[state] <= match_beg) {
+                // No match yet, or a better match may still be in progress.
+                continue;
+            }
+        }
+        result.append(str, copied, match_beg - copied);
+        result += replacer.subs_[match_sub];
+        copied = pos = match_beg + match_len;
+        match_beg = none;
+        state = 0;
+        ++count;
+    }
+    result.append(str, copied, string::npos);
+    return result;
+}
+
+
+str::TranslationTable::TranslationTable() {
+    for (size_t c(0); c < table_.size(); ++c) {
+        table_[c] = static_cast<int16_t>(c);
+    }
+}
+
+
+str::TranslationTable str::maketrans(const string& from, const string& to, const string& del) {
+    if (from.size() != to.size()) {
+        throw invalid_argument("translation strings must have equal length");
+    }
+    TranslationTable table;
+    for (size_t pos(0); pos < from.size(); ++pos) {
+        table.table_[static_cast<unsigned char>(from[pos])] = static_cast<unsigned char>(to[pos]);
+    }
+    for (const auto c: del) {
+        table.table_[static_cast<unsigned char>(c)] = -1;
+        table.deletes_ = true;
+    }
+    return table;
+}
+
+
+string str::translate(string str, const TranslationTable& table) {
+    // Translate in place, compacting the string if there are deletions.
+    if (not table.deletes_) {
+        for (auto& c: str) {
+            c = static_cast<char>(table.table_[static_cast<unsigned char>(c)]);
+        }
+        return str;
+    }
+    auto out(str.begin());
+    for (const auto c: str) {
+        const auto value(table.table_[static_cast<unsigned char>(c)]);
+        if (value >= 0) {
+            *out++ = static_cast<char>(value);
         }
     }
+    str.erase(out, str.end());
     return str;
 }
 
@@ -249,3 +775,65 @@ string str::center(const string& str, size_t width, char fill) {
     const string rpad(static_cast<size_t>(ceil(padlen)), fill);
     return lpad + str + rpad;
 }
+
+
+StringView str::view::lstrip(StringView str, const CharSet& chars) {
+    const auto first(simd::span(str.begin(), str.end(), chars.bitmap()));
+    return {first, static_cast<size_t>(str.end() - first)};
+}
+
+
+StringView str::view::rstrip(StringView str, const CharSet& chars) {
+    const auto last(simd::rspan(str.begin(), str.end(), chars.bitmap()));
+    return {str.begin(), static_cast<size_t>(last - str.begin())};
+}
+
+
+StringView str::view::strip(StringView str, const CharSet& chars) {
+    return rstrip(lstrip(str, chars), chars);
+}
+
+
+vector<StringView> str::view::split(StringView str, ssize_t maxsplit) {
+    auto items(isplit(str, maxsplit));
+    return {items.begin(), items.end()};
+}
+
+
+vector<StringView> str::view::split(StringView str, StringView sep, ssize_t maxsplit) {
+    auto items(isplit(str, string(sep), maxsplit));
+    return {items.begin(), items.end()};
+}
+
+
+vector<StringView> str::view::rsplit(StringView str, ssize_t maxsplit) {
+    auto items(irsplit(str, maxsplit));
+    vector<StringView> result(items.begin(), items.end());
+    reverse(result.begin(), result.end());
+    return result;
+}
+
+
+vector<StringView> str::view::rsplit(StringView str, StringView sep, ssize_t maxsplit) {
+    auto items(irsplit(str, string(sep), maxsplit));
+    vector<StringView> result(items.begin(), items.end());
+    reverse(result.begin(), result.end());
+    return result;
+}
+
+
+vector<StringView> str::view::splitlines(StringView str, bool keepends) {
+    auto lines(isplitlines(str, keepends));
+    return {lines.begin(), lines.end()};
+}
+
+
+bool str::view::startswith(StringView str, StringView prefix) {
+    return prefix.size() <= str.size() and std::memcmp(str.data(), prefix.data(), prefix.size()) == 0;
+}
+
+
+bool str::view::endswith(StringView str, StringView suffix) {
+    return suffix.size() <= str.size() and
+        std::memcmp(str.end() - suffix.size(), suffix.data(), suffix.size()) == 0;
+}
@@ -0,0 +1,151 @@
+/// Implementation of the internal thread pool.
+///
+#include <utility>
+#include "threadpool.hpp"
+
+
+using std::lock_guard;
+using std::mutex;
+using std::size_t;
+using std::unique_lock;
+
+using pypp::threadpool::ThreadPool;
+
+
+namespace {
+
+thread_local const ThreadPool* current_pool(nullptr);  ///< pool of this worker
+thread_local size_t current_index(0);  ///< index of this worker
+
+}  // internal linkage
+
+
+ThreadPool::ThreadPool(size_t size) {
+    if (size == 0) {
+        size = std::thread::hardware_concurrency();
+    }
+    if (size == 0) {
+        size = 1;  // unknown
+    }
+    for (size_t index(0); index < size; ++index) {
+        queues_.emplace_back(new Queue);
+    }
+    for (size_t index(0); index < size; ++index) {
+        threads_.emplace_back(&ThreadPool::run, this, index);
+    }
+}
+
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(mutex_);
+        stop_ = true;
+        failed_ = true;  // skip any remaining tasks
+    }
+    ready_.notify_all();
+    for (auto& thread: threads_) {
+        thread.join();
+    }
+}
+
+
+size_t ThreadPool::size() const {
+    return threads_.size();
+}
+
+
+void ThreadPool::submit(Task task) {
+    const auto index(current_pool == this ? current_index : next_++ % queues_.size());
+    auto& queue(*queues_[index]);
+    ++pending_;
+    {
+        lock_guard<mutex> lock(queue.mutex);
+        queue.tasks.emplace_back(std::move(task));
+    }
+    ++queued_;
+    {
+        // Synchronize with a worker that is about to wait so that the
+        // notification is not lost.
+        lock_guard<mutex> lock(mutex_);
+    }
+    ready_.notify_one();
+    return;
+}
+
+
+void ThreadPool::wait() {
+    unique_lock<mutex> lock(mutex_);
+    done_.wait(lock, [this]() { return pending_ == 0; });
+    if (error_) {
+        auto error(error_);
+        error_ = nullptr;
+        failed_ = false;
+        std::rethrow_exception(error);
+    }
+    return;
+}
+
+
+void ThreadPool::run(size_t index) {
+    current_pool = this;
+    current_index = index;
+    Task task;
+    while (true) {
+        if (take(index, task)) {
+            if (not failed_) {
+                try {
+                    task();
+                }
+                catch (...) {
+                    lock_guard<mutex> lock(mutex_);
+                    if (not error_) {
+                        error_ = std::current_exception();
+                    }
+                    failed_ = true;
+                }
+            }
+            task = nullptr;  // release captured resources
+            finish();
+            continue;
+        }
+        unique_lock<mutex> lock(mutex_);
+        ready_.wait(lock, [this]() { return stop_ or queued_ > 0; });
+        if (stop_) {
+            return;
+        }
+    }
+}
+
+
+bool ThreadPool::take(size_t index, Task& task) {
+    // Take the newest task from this worker's queue, otherwise steal the
+    // oldest task from another queue.
+    const auto size(queues_.size());
+    for (size_t count(0); count < size; ++count) {
+        auto& queue(*queues_[(index + count) % size]);
+        lock_guard<mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        if (count == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        --queued_;
+        return true;
+    }
+    return false;
+}
+
+
+void ThreadPool::finish() {
+    if (--pending_ == 0) {
+        lock_guard<mutex> lock(mutex_);
+        done_.notify_all();
+    }
+    return;
+}
@@ -0,0 +1,106 @@
+/// Work-stealing thread pool shared by the library implementation.
+///
+/// This is not part of the public API.
+///
+#ifndef PYPP_THREADPOOL_HPP
+#define PYPP_THREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace pypp { namespace threadpool {
+
+/// Pool of worker threads for running tasks.
+///
+/// Each worker has its own task queue. A task submitted by a worker is added
+/// to its own queue, and a worker takes the newest task from its own queue
+/// first, so recursive work proceeds depth-first with good locality. An idle
+/// worker steals the oldest task from another queue, which tends to be the
+/// largest remaining unit of work.
+///
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    /// Start the worker threads.
+    ///
+    /// @param size number of threads, or 0 to use the number of CPUs
+    explicit ThreadPool(std::size_t size=0);
+
+    ThreadPool(const ThreadPool&) = delete;
+
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// Stop the worker threads.
+    ///
+    /// Any tasks that have not started yet are discarded.
+    ///
+    ~ThreadPool();
+
+    /// Get the number of worker threads.
+    ///
+    /// @return pool size
+    std::size_t size() const;
+
+    /// Add a task to the pool.
+    ///
+    /// This may be called from any thread, including from a running task.
+    ///
+    /// @param task task to run
+    void submit(Task task);
+
+    /// Wait for all tasks to finish.
+    ///
+    /// This includes tasks that are submitted by other tasks. If a task throws
+    /// an exception, any tasks that have not started yet are discarded and the
+    /// first exception is rethrown here.
+    ///
+    void wait();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::condition_variable done_;
+    std::atomic<std::size_t> queued_{0};
+    std::atomic<std::size_t> pending_{0};
+    std::atomic<std::size_t> next_{0};
+    std::atomic<bool> failed_{false};
+    std::exception_ptr error_;
+    bool stop_{false};
+
+    /// Run tasks in a worker thread.
+    ///
+    /// @param index worker index
+    void run(std::size_t index);
+
+    /// Take a task, stealing from another worker if necessary.
+    ///
+    /// @param index worker index
+    /// @param task output task
+    /// @return true if a task was found
+    bool take(std::size_t index, Task& task);
+
+    /// Mark a task as finished.
+    ///
+    void finish();
+};
+
+}}  // namespace pypp::threadpool
+
+#endif  // PYPP_THREADPOOL_HPP
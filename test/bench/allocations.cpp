@@ -0,0 +1,91 @@
+/// Replacement allocation functions that count heap allocations.
+///
+/// These are in their own translation unit so that the compiler cannot
+/// inline them into callers, where GCC would misreport the malloc/free pairs
+/// as mismatched with operator new/delete.
+///
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "allocations.hpp"
+
+
+namespace {
+
+std::atomic<std::size_t> count(0);  ///< running count of heap allocations
+
+
+/// Allocate memory and count the allocation.
+///
+/// @param size number of bytes
+/// @return allocated memory, or nullptr on failure
+void* allocate(std::size_t size) noexcept {
+    ++count;
+    return std::malloc(size ? size : 1);
+}
+
+}  // internal linkage
+
+
+std::size_t allocations() {
+    return count.load();
+}
+
+
+// The complete set of unaligned allocation functions is replaced so that all
+// memory is released by the matching function.
+
+void* operator new(std::size_t size) {
+    if (const auto ptr = allocate(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+
+void* operator new[](std::size_t size) {
+    if (const auto ptr = allocate(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
@@ -0,0 +1,18 @@
+/// Heap allocation counting for benchmarks.
+///
+/// Linking allocations.cpp replaces the global allocation functions for the
+/// whole executable, so it is only linked into the instrumented benchmark
+/// runner, not the main one.
+///
+#ifndef PYPP_BENCH_ALLOCATIONS_HPP
+#define PYPP_BENCH_ALLOCATIONS_HPP
+
+#include <cstddef>
+
+
+/// Get the number of heap allocations so far.
+///
+/// @return running count of allocations
+std::size_t allocations();
+
+#endif  // PYPP_BENCH_ALLOCATIONS_HPP
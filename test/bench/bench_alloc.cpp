@@ -0,0 +1,62 @@
+/// Benchmarks that count heap allocations.
+///
+/// Link with allocations.cpp and the `benchmark_main` library to create a
+/// command-line benchmark runner.
+///
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "pypp/pypp.hpp"
+#include "allocations.hpp"
+
+
+using benchmark::Counter;
+using benchmark::DoNotOptimize;
+using benchmark::State;
+using std::string;
+using std::vector;
+
+using pypp::path::PurePosixPath;
+
+
+namespace {
+
+/// Generate path strings.
+///
+/// @param count number of paths
+/// @param depth number of components in each path
+/// @return paths
+vector<string> paths(size_t count, size_t depth) {
+    vector<string> values;
+    for (size_t i(0); i < count; ++i) {
+        string path;
+        for (size_t j(0); j < depth; ++j) {
+            path += "/dir" + std::to_string((i + j) % 100);
+        }
+        values.emplace_back(path + "/file.txt");
+    }
+    return values;
+}
+
+}  // internal linkage
+
+
+/// Benchmark PurePosixPath construction.
+///
+static void BM_path_construct(State& state) {
+    const auto values(paths(1024, state.range(0)));
+    size_t count(0);
+    const auto start(allocations());
+    for (auto _: state) {
+        for (const auto& value: values) {
+            PurePosixPath path(value);
+            DoNotOptimize(path);
+        }
+        count += values.size();
+    }
+    state.counters["allocs"] = Counter(
+        static_cast<double>(allocations() - start) / count);
+    state.SetItemsProcessed(count);
+}
+
+BENCHMARK(BM_path_construct)->Arg(1)->Arg(4)->Arg(16);
@@ -0,0 +1,187 @@
+/// Benchmarks for the convert module.
+///
+/// Link all benchmark files with the `benchmark_main` library to create a
+/// command-line benchmark runner.
+///
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "pypp/pypp.hpp"
+
+
+using benchmark::DoNotOptimize;
+using benchmark::State;
+using std::string;
+using std::vector;
+
+using namespace pypp;
+
+
+namespace {
+
+/// Generate random integers as strings.
+///
+/// @param count number of values
+/// @return values
+vector<string> integers(size_t count) {
+    vector<string> values;
+    uint64_t seed(12345);
+    for (size_t i(0); i < count; ++i) {
+        seed = seed * 6364136223846793005 + 1442695040888963407;
+        values.emplace_back(std::to_string(static_cast<int64_t>(seed) >> (seed % 48)));
+    }
+    return values;
+}
+
+
+/// Generate random floating point numbers as strings.
+///
+/// @param count number of values
+/// @param digits significant digits
+/// @return values
+vector<string> floats(size_t count, int digits) {
+    vector<string> values;
+    uint64_t seed(12345);
+    char buffer[32];
+    for (size_t i(0); i < count; ++i) {
+        seed = seed * 6364136223846793005 + 1442695040888963407;
+        const auto value(static_cast<double>(seed >> 11) / (uint64_t{1} << 53) * 1000);
+        std::snprintf(buffer, sizeof(buffer), "%.*g", digits, value);
+        values.emplace_back(buffer);
+    }
+    return values;
+}
+
+}  // internal linkage
+
+
+/// Benchmark std::stoll() as a baseline for from_chars().
+///
+void BM_stoll(State& state) {
+    const auto values(integers(1000));
+    for (auto _: state) {
+        for (const auto& str: values) {
+            DoNotOptimize(std::stoll(str));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+BENCHMARK(BM_stoll);
+
+
+/// Benchmark the from_chars() function for integers.
+///
+void BM_from_chars_int(State& state) {
+    const auto values(integers(1000));
+    for (auto _: state) {
+        for (const auto& str: values) {
+            long long value;
+            DoNotOptimize(convert::from_chars(str.data(), str.data() + str.size(), value));
+            DoNotOptimize(value);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+BENCHMARK(BM_from_chars_int);
+
+
+/// Benchmark std::strtod() as a baseline for from_chars().
+///
+void BM_strtod(State& state) {
+    const auto values(floats(1000, state.range(0)));
+    for (auto _: state) {
+        for (const auto& str: values) {
+            DoNotOptimize(std::strtod(str.c_str(), nullptr));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+BENCHMARK(BM_strtod)->Arg(6)->Arg(17);
+
+
+/// Benchmark the from_chars() function for floating point numbers.
+///
+void BM_from_chars_float(State& state) {
+    const auto values(floats(1000, state.range(0)));
+    for (auto _: state) {
+        for (const auto& str: values) {
+            double value;
+            DoNotOptimize(convert::from_chars(str.data(), str.data() + str.size(), value));
+            DoNotOptimize(value);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+BENCHMARK(BM_from_chars_float)->Arg(6)->Arg(17);
+
+
+/// Benchmark std::to_string() as a baseline for to_str().
+///
+void BM_to_string(State& state) {
+    const auto values(integers(1000));
+    vector<long long> numbers;
+    for (const auto& str: values) {
+        numbers.push_back(std::stoll(str));
+    }
+    for (auto _: state) {
+        for (const auto value: numbers) {
+            DoNotOptimize(std::to_string(value));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * numbers.size());
+}
+BENCHMARK(BM_to_string);
+
+
+/// Benchmark the to_chars() function for integers.
+///
+void BM_to_chars_int(State& state) {
+    const auto values(integers(1000));
+    vector<long long> numbers;
+    for (const auto& str: values) {
+        numbers.push_back(std::stoll(str));
+    }
+    char buffer[32];
+    for (auto _: state) {
+        for (const auto value: numbers) {
+            DoNotOptimize(convert::to_chars(buffer, buffer + sizeof(buffer), value));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * numbers.size());
+}
+BENCHMARK(BM_to_chars_int);
+
+
+/// Benchmark the to_chars() function for floating point numbers.
+///
+void BM_to_chars_float(State& state) {
+    const auto values(floats(1000, state.range(0)));
+    vector<double> numbers;
+    for (const auto& str: values) {
+        numbers.push_back(std::strtod(str.c_str(), nullptr));
+    }
+    char buffer[32];
+    for (auto _: state) {
+        for (const auto value: numbers) {
+            DoNotOptimize(convert::to_chars(buffer, buffer + sizeof(buffer), value));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * numbers.size());
+}
+BENCHMARK(BM_to_chars_float)->Arg(6)->Arg(17);
+
+
+/// Benchmark the parse_fields() function for a CSV record.
+///
+void BM_parse_fields(State& state) {
+    const auto values(floats(state.range(0), 6));
+    const auto record(str::join(values, ","));
+    for (auto _: state) {
+        DoNotOptimize(convert::parse_fields<double>(record, ","));
+    }
+    state.SetBytesProcessed(state.iterations() * record.size());
+}
+BENCHMARK(BM_parse_fields)->Arg(1000);
@@ -0,0 +1,151 @@
+/// Benchmarks for the fnmatch module.
+///
+/// Link all benchmark files with the `benchmark_main` library to create a
+/// command-line benchmark runner.
+///
+#include <regex>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "pypp/pypp.hpp"
+
+
+using benchmark::DoNotOptimize;
+using benchmark::State;
+using std::regex;
+using std::string;
+using std::vector;
+
+using namespace pypp;
+
+
+namespace {
+
+/// Get file names shared by all benchmarks.
+///
+/// @return file names
+const vector<string>& names() {
+    static const char* exts[] = {"txt", "cpp", "hpp", "o", "tmp", "log", "json", "md"};
+    static vector<string> names;
+    if (names.empty()) {
+        for (size_t i(0); i < 100000; ++i) {
+            names.emplace_back("src/module" + std::to_string(i % 100) + "/file_" + std::to_string(i) + "." + exts[i % 8]);
+        }
+    }
+    return names;
+}
+
+
+/// Exclude patterns for the pattern set benchmarks.
+///
+const vector<string> excludes({"*.o", "*.tmp", "*~", "build/*", "*/.git/*", "*.log", "*_test.cpp", "*[0-9][0-9][0-9]9.md"});
+
+}  // internal linkage
+
+
+/// Benchmark matching one pattern with std::regex.
+///
+/// This is the pattern translated by fnmatch::translate().
+///
+static void BM_regex_match(State& state) {
+    const regex pattern(fnmatch::translate("*/file_*[0-9].cpp"));
+    for (auto _: state) {
+        size_t count(0);
+        for (const auto& name: names()) {
+            count += std::regex_match(name, pattern);
+        }
+        DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * names().size());
+}
+
+BENCHMARK(BM_regex_match)->Unit(benchmark::kMillisecond);
+
+
+/// Benchmark matching one pattern with fnmatch::Pattern.
+///
+static void BM_Pattern_match(State& state) {
+    const fnmatch::Pattern pattern("*/file_*[0-9].cpp");
+    for (auto _: state) {
+        size_t count(0);
+        for (const auto& name: names()) {
+            count += pattern.match(name);
+        }
+        DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * names().size());
+}
+
+BENCHMARK(BM_Pattern_match)->Unit(benchmark::kMillisecond);
+
+
+/// Benchmark matching one pattern with fnmatch::fnmatch().
+///
+/// This includes the lookup of the cached pattern.
+///
+static void BM_fnmatch(State& state) {
+    const string pattern("*/file_*[0-9].cpp");
+    for (auto _: state) {
+        size_t count(0);
+        for (const auto& name: names()) {
+            count += fnmatch::fnmatch(name, pattern);
+        }
+        DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * names().size());
+}
+
+BENCHMARK(BM_fnmatch)->Unit(benchmark::kMillisecond);
+
+
+/// Benchmark matching a set of patterns with one std::regex per pattern.
+///
+static void BM_regex_set(State& state) {
+    vector<regex> patterns;
+    for (const auto& pattern: excludes) {
+        patterns.emplace_back(fnmatch::translate(pattern));
+    }
+    for (auto _: state) {
+        size_t count(0);
+        for (const auto& name: names()) {
+            for (const auto& pattern: patterns) {
+                if (std::regex_match(name, pattern)) {
+                    ++count;
+                    break;
+                }
+            }
+        }
+        DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * names().size());
+}
+
+BENCHMARK(BM_regex_set)->Unit(benchmark::kMillisecond);
+
+
+/// Benchmark matching a set of patterns with one fnmatch::Pattern.
+///
+static void BM_Pattern_set(State& state) {
+    const fnmatch::Pattern patterns(excludes);
+    for (auto _: state) {
+        size_t count(0);
+        for (const auto& name: names()) {
+            count += patterns.match(name);
+        }
+        DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * names().size());
+}
+
+BENCHMARK(BM_Pattern_set)->Unit(benchmark::kMillisecond);
+
+
+/// Benchmark compiling a set of patterns.
+///
+static void BM_Pattern_compile(State& state) {
+    for (auto _: state) {
+        DoNotOptimize(fnmatch::Pattern(excludes));
+    }
+}
+
+BENCHMARK(BM_Pattern_compile)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,123 @@
+/// Benchmarks for the glob module.
+///
+/// Link all benchmark files with the `benchmark_main` library to create a
+/// command-line benchmark runner.
+///
+#include <fcntl.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "pypp/pypp.hpp"
+
+
+using benchmark::DoNotOptimize;
+using benchmark::State;
+using pypp::path::Path;
+using pypp::tempfile::TemporaryDirectory;
+using std::string;
+using std::vector;
+
+using namespace pypp;
+
+
+namespace {
+
+/// Get a directory tree shared by all benchmarks.
+///
+/// Each directory has `width` subdirectories, `width` ".txt" files, and
+/// `width` ".dat" files.
+///
+/// @param width number of entries of each kind per directory
+/// @param depth number of directory levels
+/// @return tree root
+const string& tree(size_t width, size_t depth) {
+    static const TemporaryDirectory tmpdir;
+    static const string root(tmpdir.name());
+    static bool created(false);
+    if (not created) {
+        vector<string> dirs({root});
+        for (size_t level(0); level < depth; ++level) {
+            vector<string> subdirs;
+            for (const auto& dir: dirs) {
+                for (size_t i(0); i < width; ++i) {
+                    const auto name(std::to_string(i));
+                    close(creat(path::join({dir, name + ".txt"}).c_str(), 0600));
+                    close(creat(path::join({dir, name + ".dat"}).c_str(), 0600));
+                    subdirs.emplace_back(path::join({dir, "d" + name}));
+                    os::makedirs(subdirs.back());
+                }
+            }
+            dirs.swap(subdirs);
+        }
+        created = true;
+    }
+    return root;
+}
+
+
+/// Recursively find files by comparing names by hand.
+///
+/// This is the iterdir() idiom that glob::glob() replaces.
+///
+/// @param root root directory
+/// @param suffix file name suffix
+/// @param paths matching paths
+void find_manual(const Path& root, const string& suffix, vector<Path>& paths) {
+    for (const auto& path: root.iterdir()) {
+        if (path.is_dir()) {
+            find_manual(path, suffix, paths);
+        }
+        else if (str::endswith(path.name(), suffix)) {
+            paths.emplace_back(path);
+        }
+    }
+    return;
+}
+
+}  // internal linkage
+
+
+/// Benchmark a recursive search with Path::iterdir().
+///
+static void BM_iterdir_manual(State& state) {
+    const Path root(tree(8, 4));
+    for (auto _: state) {
+        vector<Path> paths;
+        find_manual(root, ".txt", paths);
+        DoNotOptimize(paths);
+    }
+}
+
+BENCHMARK(BM_iterdir_manual)->Unit(benchmark::kMillisecond);
+
+
+/// Benchmark a recursive search with glob::iglob().
+///
+static void BM_iglob(State& state) {
+    const auto pattern(glob::escape(tree(8, 4)) + "/**/*.txt");
+    for (auto _: state) {
+        size_t count(0);
+        for (const auto& path: glob::iglob(pattern, true)) {
+            DoNotOptimize(path);
+            ++count;
+        }
+        DoNotOptimize(count);
+    }
+}
+
+BENCHMARK(BM_iglob)->Unit(benchmark::kMillisecond);
+
+
+/// Benchmark a recursive search with glob::glob().
+///
+/// The argument is the number of threads.
+///
+static void BM_glob(State& state) {
+    const auto pattern(glob::escape(tree(8, 4)) + "/**/*.txt");
+    for (auto _: state) {
+        DoNotOptimize(glob::glob(pattern, true, state.range(0)));
+    }
+}
+
+BENCHMARK(BM_glob)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,366 @@
+/// Benchmarks for the os module.
+///
+/// Link all benchmark files with the `benchmark_main` library to create a
+/// command-line benchmark runner.
+///
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "pypp/pypp.hpp"
+
+
+using benchmark::DoNotOptimize;
+using benchmark::State;
+using pypp::path::Path;
+using pypp::tempfile::TemporaryDirectory;
+using std::fstream;
+using std::string;
+
+using namespace pypp;
+
+
+namespace {
+
+/// Create a temporary directory with a mix of files and directories.
+///
+/// @param count number of entries
+/// @return directory
+const TemporaryDirectory& directory(size_t count) {
+    static TemporaryDirectory tmpdir;
+    static size_t size(0);
+    for (; size < count; ++size) {
+        const auto name(path::join({tmpdir.name(), std::to_string(size)}));
+        if (size % 10 == 0) {
+            os::makedirs(name);
+        }
+        else {
+            fstream(name, fstream::out);
+        }
+    }
+    return tmpdir;
+}
+
+
+
+/// Create a temporary directory tree.
+///
+/// Each directory has `width` subdirectories and `width` files, down to a
+/// depth of `depth`.
+///
+/// @param width number of subdirectories and files per directory
+/// @param depth tree depth
+/// @return directory
+const TemporaryDirectory& tree(size_t width, size_t depth) {
+    static TemporaryDirectory tmpdir;
+    static bool created(false);
+    if (not created) {
+        std::vector<string> dirs({tmpdir.name()});
+        for (size_t level(0); level < depth; ++level) {
+            std::vector<string> subdirs;
+            for (const auto& dir: dirs) {
+                for (size_t i(0); i < width; ++i) {
+                    fstream(path::join({dir, "f" + std::to_string(i)}), fstream::out);
+                    subdirs.emplace_back(path::join({dir, "d" + std::to_string(i)}));
+                    os::makedirs(subdirs.back());
+                }
+            }
+            dirs.swap(subdirs);
+        }
+        created = true;
+    }
+    return tmpdir;
+}
+
+
+
+/// Create a temporary file.
+///
+/// @param size file size in bytes
+/// @return file path
+Path file(size_t size) {
+    static TemporaryDirectory tmpdir;
+    const auto path(Path(tmpdir.name()) / std::to_string(size));
+    if (not path.exists()) {
+        path.write_bytes(string(size, 'x'));
+    }
+    return path;
+}
+
+
+/// Get the size of a file.
+///
+/// @param path file path
+/// @return size in bytes
+size_t file_size(const Path& path) {
+    return path.read_bytes().size();
+}
+
+
+/// Generate a log record.
+///
+/// @param index record index
+/// @return record, including a line ending
+string record(size_t index) {
+    return "2024-01-01T00:00:00 INFO request " + std::to_string(index) + " completed\n";
+}
+
+
+/// Create a temporary text file.
+///
+/// @return file path
+Path text_file() {
+    static const auto path(file(0).parent() / "lines.txt");
+    if (not path.exists()) {
+        string data;
+        for (size_t i(0); data.size() < (16 << 20); ++i) {
+            data += record(i);
+        }
+        path.write_bytes(data);
+    }
+    return path;
+}
+
+}  // internal linkage
+
+
+/// Benchmark finding directories with Path::iterdir() and Path::is_dir().
+///
+static void BM_iterdir_is_dir(State& state) {
+    const Path root(directory(state.range(0)).name());
+    for (auto _: state) {
+        size_t dirs(0);
+        for (const auto& path: root.iterdir()) {
+            dirs += path.is_dir();
+        }
+        DoNotOptimize(dirs);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_iterdir_is_dir)->Arg(1000);
+
+
+/// Benchmark finding directories with os::scandir().
+///
+static void BM_scandir_is_dir(State& state) {
+    const auto root(directory(state.range(0)).name());
+    for (auto _: state) {
+        size_t dirs(0);
+        for (const auto& entry: os::scandir(root)) {
+            dirs += entry.is_dir();
+        }
+        DoNotOptimize(dirs);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_scandir_is_dir)->Arg(1000);
+
+
+/// Benchmark walking a directory tree with os::walk().
+///
+static void BM_walk(State& state) {
+    const auto root(tree(8, 4).name());
+    for (auto _: state) {
+        size_t files(0);
+        for (const auto& entry: os::walk(root)) {
+            files += entry.filenames.size();
+        }
+        DoNotOptimize(files);
+    }
+}
+
+BENCHMARK(BM_walk)->Unit(benchmark::kMillisecond);
+
+
+/// Benchmark walking a directory tree with os::walk_parallel().
+///
+static void BM_walk_parallel(State& state) {
+    const auto root(tree(8, 4).name());
+    for (auto _: state) {
+        std::atomic<size_t> files(0);
+        os::walk_parallel(root, [&files](os::WalkEntry& entry) {
+            files += entry.filenames.size();
+        }, nullptr, false, state.range(0));
+        DoNotOptimize(files.load());
+    }
+}
+
+BENCHMARK(BM_walk_parallel)->Arg(1)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+
+/// Benchmark reading a file through a stream buffer.
+///
+/// This is the stream-based implementation that Path::read_bytes() replaces.
+///
+static void BM_read_stream(State& state) {
+    const auto path(file(state.range(0)));
+    for (auto _: state) {
+        auto stream(path.open("rb"));
+        std::ostringstream buffer;
+        buffer << stream.rdbuf();
+        DoNotOptimize(buffer.str());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_read_stream)->Arg(4 << 10)->Arg(1 << 20)->Arg(16 << 20);
+
+
+/// Benchmark reading a file with Path::read_bytes().
+///
+static void BM_read_bytes(State& state) {
+    const auto path(file(state.range(0)));
+    for (auto _: state) {
+        DoNotOptimize(path.read_bytes());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_read_bytes)->Arg(4 << 10)->Arg(1 << 20)->Arg(16 << 20);
+
+
+/// Benchmark reading a file with a MappedFile.
+///
+/// Every page is touched so that the cost of faulting in the data is included.
+///
+static void BM_mapped_file(State& state) {
+    const string name(file(state.range(0)));
+    for (auto _: state) {
+        const path::MappedFile mapped(name);
+        size_t sum(0);
+        for (size_t pos(0); pos < mapped.size(); pos += 4096) {
+            sum += mapped.data()[pos];
+        }
+        DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_mapped_file)->Arg(4 << 10)->Arg(1 << 20)->Arg(16 << 20);
+
+
+/// Benchmark reading lines with std::getline().
+///
+static void BM_getline(State& state) {
+    const auto path(text_file());
+    for (auto _: state) {
+        auto stream(path.open("rt"));
+        string line;
+        size_t count(0);
+        while (std::getline(stream, line)) {
+            ++count;
+        }
+        DoNotOptimize(count);
+    }
+    state.SetBytesProcessed(state.iterations() * file_size(path));
+}
+
+BENCHMARK(BM_getline)->Unit(benchmark::kMillisecond);
+
+
+/// Benchmark reading lines with Path::lines().
+///
+/// The argument is the buffer size.
+///
+static void BM_lines(State& state) {
+    const auto path(text_file());
+    for (auto _: state) {
+        size_t count(0);
+        for (const auto line: path.lines(false, state.range(0))) {
+            DoNotOptimize(line);
+            ++count;
+        }
+        DoNotOptimize(count);
+    }
+    state.SetBytesProcessed(state.iterations() * file_size(path));
+}
+
+BENCHMARK(BM_lines)->Arg(4 << 10)->Arg(64 << 10)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+
+/// Benchmark writing records to a std::fstream.
+///
+static void BM_write_fstream(State& state) {
+    const auto path(file(0).parent() / "write.txt");
+    const auto data(record(0));
+    for (auto _: state) {
+        auto stream(path.open("wt"));
+        for (auto i(0); i < state.range(0); ++i) {
+            stream << data;
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * data.size());
+}
+
+BENCHMARK(BM_write_fstream)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+
+/// Benchmark writing records with Path::writer().
+///
+static void BM_writer(State& state) {
+    const auto path(file(0).parent() / "write.txt");
+    const auto data(record(0));
+    for (auto _: state) {
+        auto writer(path.writer());
+        for (auto i(0); i < state.range(0); ++i) {
+            writer.write(data);
+        }
+        writer.close();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * data.size());
+}
+
+BENCHMARK(BM_writer)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+
+/// Benchmark testing many paths with path::isfile().
+///
+static void BM_isfile_serial(State& state) {
+    const Path root(directory(state.range(0)).name());
+    std::vector<string> paths;
+    for (const auto& path: root.iterdir()) {
+        paths.emplace_back(path);
+    }
+    for (auto _: state) {
+        size_t files(0);
+        for (const auto& path: paths) {
+            files += path::isfile(path);
+        }
+        DoNotOptimize(files);
+    }
+    state.SetItemsProcessed(state.iterations() * paths.size());
+}
+
+BENCHMARK(BM_isfile_serial)->Arg(10000);
+
+
+/// Benchmark testing many paths with os::stat_many().
+///
+/// The second argument is nonzero to disable io_uring.
+///
+static void BM_stat_many(State& state) {
+    const Path root(directory(state.range(0)).name());
+    std::vector<string> paths;
+    for (const auto& path: root.iterdir()) {
+        paths.emplace_back(path);
+    }
+    if (state.range(1)) {
+        setenv("PYPP_DISABLE_IO_URING", "1", 1);
+    }
+    for (auto _: state) {
+        size_t files(0);
+        for (const auto& result: os::stat_many(paths)) {
+            files += result.error == 0 and S_ISREG(result.status.st_mode);
+        }
+        DoNotOptimize(files);
+    }
+    unsetenv("PYPP_DISABLE_IO_URING");
+    state.SetItemsProcessed(state.iterations() * paths.size());
+}
+
+BENCHMARK(BM_stat_many)->Args({10000, 0})->Args({10000, 1})->UseRealTime();
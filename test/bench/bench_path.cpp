@@ -0,0 +1,206 @@
+/// Benchmarks for the path module.
+///
+/// Link all benchmark files with the `benchmark_main` library to create a
+/// command-line benchmark runner.
+///
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "pypp/pypp.hpp"
+
+
+using benchmark::Counter;
+using benchmark::DoNotOptimize;
+using benchmark::State;
+using std::string;
+using std::vector;
+
+using pypp::path::PurePosixPath;
+
+
+namespace {
+
+/// Generate path strings.
+///
+/// @param count number of paths
+/// @param depth number of components in each path
+/// @return paths
+vector<string> paths(size_t count, size_t depth) {
+    vector<string> values;
+    for (size_t i(0); i < count; ++i) {
+        string path;
+        for (size_t j(0); j < depth; ++j) {
+            path += "/dir" + std::to_string((i + j) % 100);
+        }
+        values.emplace_back(path + "/file.txt");
+    }
+    return values;
+}
+
+}  // internal linkage
+
+
+/// Benchmark the memory held by a PurePosixPath.
+///
+static void BM_path_sizeof(State& state) {
+    const auto values(paths(1024, state.range(0)));
+    for (auto _: state) {
+        vector<PurePosixPath> stored(values.begin(), values.end());
+        DoNotOptimize(stored.data());
+    }
+    state.counters["bytes"] = Counter(sizeof(PurePosixPath));
+}
+
+BENCHMARK(BM_path_sizeof)->Arg(1)->Arg(4);
+
+
+/// Benchmark PurePosixPath::parent().
+///
+static void BM_path_parent(State& state) {
+    const PurePosixPath path(paths(1, 8)[0]);
+    for (auto _: state) {
+        DoNotOptimize(path.parent());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_path_parent);
+
+
+/// Benchmark PurePosixPath::name().
+///
+static void BM_path_name(State& state) {
+    const PurePosixPath path(paths(1, 8)[0]);
+    for (auto _: state) {
+        DoNotOptimize(path.name());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_path_name);
+
+
+/// Benchmark the normpath() function.
+///
+static void BM_normpath(State& state) {
+    const auto values(paths(1024, 4));
+    for (auto _: state) {
+        for (const auto& value: values) {
+            DoNotOptimize(pypp::path::normpath(value + "/../."));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK(BM_normpath);
+
+
+/// Benchmark path deduplication with std::set.
+///
+static void BM_path_set(State& state) {
+    const auto strings(paths(4096, 4));
+    const vector<PurePosixPath> values(strings.begin(), strings.end());
+    for (auto _: state) {
+        std::set<PurePosixPath> unique;
+        for (const auto& value: values) {
+            unique.insert(value);
+            unique.insert(value);
+        }
+        DoNotOptimize(unique.size());
+    }
+    state.SetItemsProcessed(state.iterations() * values.size() * 2);
+}
+
+BENCHMARK(BM_path_set);
+
+
+/// Benchmark path deduplication with std::unordered_set.
+///
+static void BM_path_unordered_set(State& state) {
+    const auto strings(paths(4096, 4));
+    const vector<PurePosixPath> values(strings.begin(), strings.end());
+    for (auto _: state) {
+        std::unordered_set<PurePosixPath> unique;
+        for (const auto& value: values) {
+            unique.insert(value);
+            unique.insert(value);
+        }
+        DoNotOptimize(unique.size());
+    }
+    state.SetItemsProcessed(state.iterations() * values.size() * 2);
+}
+
+BENCHMARK(BM_path_unordered_set);
+
+
+/// Benchmark building a deep path by joining one component at a time.
+///
+static void BM_path_join_deep(State& state) {
+    static const size_t depth(50);
+    for (auto _: state) {
+        PurePosixPath path("/root");
+        for (size_t i(0); i < depth; ++i) {
+            path /= "dir";
+        }
+        DoNotOptimize(path);
+    }
+    state.SetItemsProcessed(state.iterations() * depth);
+}
+
+BENCHMARK(BM_path_join_deep);
+
+
+/// Benchmark PurePosixPath::with_name().
+///
+static void BM_path_with_name(State& state) {
+    const PurePosixPath path(paths(1, 4)[0]);
+    for (auto _: state) {
+        DoNotOptimize(path.with_name("output.dat"));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_path_with_name);
+
+
+/// Benchmark PurePosixPath::with_suffix().
+///
+static void BM_path_with_suffix(State& state) {
+    const PurePosixPath path(paths(1, 4)[0]);
+    for (auto _: state) {
+        DoNotOptimize(path.with_suffix(".dat"));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_path_with_suffix);
+
+
+/// Benchmark PurePosixPath::parents() for a deep path.
+///
+static void BM_path_parents(State& state) {
+    const PurePosixPath path(paths(1, 50)[0]);
+    for (auto _: state) {
+        DoNotOptimize(path.parents());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_path_parents);
+
+
+/// Benchmark PurePosixPath::ancestors() for a deep path.
+///
+static void BM_path_ancestors(State& state) {
+    const PurePosixPath path(paths(1, 50)[0]);
+    for (auto _: state) {
+        for (const auto ancestor: path.ancestors()) {
+            DoNotOptimize(ancestor);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_path_ancestors);
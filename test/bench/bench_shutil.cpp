@@ -0,0 +1,95 @@
+/// Benchmarks for the shutil module.
+///
+/// Link all benchmark files with the `benchmark_main` library to create a
+/// command-line benchmark runner.
+///
+#include <fcntl.h>
+#include <unistd.h>
+#include <string>
+#include <benchmark/benchmark.h>
+#include "pypp/pypp.hpp"
+
+
+using benchmark::State;
+using pypp::path::Path;
+using pypp::tempfile::TemporaryDirectory;
+using std::string;
+
+using namespace pypp;
+
+
+namespace {
+
+/// Create a directory tree.
+///
+/// @param root root directory
+/// @param dirs number of subdirectories
+/// @param files number of files per subdirectory
+void tree(const string& root, size_t dirs, size_t files) {
+    for (size_t i(0); i < dirs; ++i) {
+        const auto dir(path::join({root, std::to_string(i)}));
+        os::makedirs(dir);
+        for (size_t j(0); j < files; ++j) {
+            close(creat(path::join({dir, std::to_string(j)}).c_str(), 0600));
+        }
+    }
+    return;
+}
+
+
+/// Remove a directory tree using full paths.
+///
+/// This is the path-based implementation that shutil::rmtree() replaces.
+///
+/// @param root root directory
+void rmtree_path(const Path& root) {
+    for (const auto& path: root.iterdir()) {
+        if (path.is_dir() and not path.is_symlink()) {
+            rmtree_path(path);
+        }
+        else {
+            path.unlink();
+        }
+    }
+    root.rmdir();
+    return;
+}
+
+}  // internal linkage
+
+
+/// Benchmark removing a directory tree with Path operations.
+///
+static void BM_rmtree_path(State& state) {
+    const TemporaryDirectory tmpdir;
+    const auto root(path::join({tmpdir.name(), "root"}));
+    for (auto _: state) {
+        state.PauseTiming();
+        tree(root, 10, state.range(0) / 10);
+        state.ResumeTiming();
+        rmtree_path(Path(root));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_rmtree_path)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+
+/// Benchmark removing a directory tree with shutil::rmtree().
+///
+/// The argument is the number of threads.
+///
+static void BM_rmtree(State& state) {
+    static const size_t count(10000);
+    const TemporaryDirectory tmpdir;
+    const auto root(path::join({tmpdir.name(), "root"}));
+    for (auto _: state) {
+        state.PauseTiming();
+        tree(root, 10, count / 10);
+        state.ResumeTiming();
+        shutil::rmtree(root, false, state.range(0));
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_rmtree)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,108 @@
+/// Benchmarks that count stat() calls.
+///
+/// Link with stat_calls.cpp and the `benchmark_main` library to create a
+/// command-line benchmark runner.
+///
+#include <fstream>
+#include <string>
+#include <benchmark/benchmark.h>
+#include "pypp/pypp.hpp"
+#include "stat_calls.hpp"
+
+
+using benchmark::Counter;
+using benchmark::DoNotOptimize;
+using benchmark::State;
+using pypp::path::Path;
+using pypp::tempfile::TemporaryDirectory;
+using std::fstream;
+
+using namespace pypp;
+
+
+namespace {
+
+/// Create a temporary directory with a mix of files and directories.
+///
+/// @param count number of entries
+/// @return directory
+const TemporaryDirectory& directory(size_t count) {
+    static TemporaryDirectory tmpdir;
+    static size_t size(0);
+    for (; size < count; ++size) {
+        const auto name(path::join({tmpdir.name(), std::to_string(size)}));
+        if (size % 10 == 0) {
+            os::makedirs(name);
+        }
+        else {
+            fstream(name, fstream::out);
+        }
+    }
+    return tmpdir;
+}
+
+
+/// Check that stat() calls are being counted.
+///
+/// @param state benchmark state to skip if they are not
+/// @return true if calls are counted
+bool counting(State& state) {
+    const auto start(stat_calls());
+    DoNotOptimize(Path(".").is_dir());
+    if (stat_calls() == start) {
+        state.SkipWithError("stat() calls are not counted on this platform");
+        return false;
+    }
+    return true;
+}
+
+}  // internal linkage
+
+
+/// Benchmark testing several predicates with Path methods.
+///
+static void BM_path_predicates(State& state) {
+    if (not counting(state)) {
+        return;
+    }
+    const Path root(directory(state.range(0)).name());
+    const auto paths(root.iterdir());
+    const auto start(stat_calls());
+    for (auto _: state) {
+        size_t count(0);
+        for (const auto& path: paths) {
+            count += path.exists() + path.is_dir() + path.is_file() + path.is_symlink();
+        }
+        DoNotOptimize(count);
+    }
+    const auto calls(static_cast<double>(stat_calls() - start));
+    state.counters["stats"] = Counter(calls / (state.iterations() * paths.size()));
+    state.SetItemsProcessed(state.iterations() * paths.size());
+}
+
+BENCHMARK(BM_path_predicates)->Arg(1000);
+
+
+/// Benchmark testing several predicates with Path::info().
+///
+static void BM_path_info(State& state) {
+    if (not counting(state)) {
+        return;
+    }
+    const Path root(directory(state.range(0)).name());
+    const auto paths(root.iterdir());
+    const auto start(stat_calls());
+    for (auto _: state) {
+        size_t count(0);
+        for (const auto& path: paths) {
+            const auto info(path.info());
+            count += info.exists() + info.is_dir() + info.is_file() + info.is_symlink();
+        }
+        DoNotOptimize(count);
+    }
+    const auto calls(static_cast<double>(stat_calls() - start));
+    state.counters["stats"] = Counter(calls / (state.iterations() * paths.size()));
+    state.SetItemsProcessed(state.iterations() * paths.size());
+}
+
+BENCHMARK(BM_path_info)->Arg(1000);
@@ -0,0 +1,430 @@
+/// Benchmarks for the string module.
+///
+/// Link all benchmark files with the `benchmark_main` library to create a
+/// command-line benchmark runner.
+///
+#include <algorithm>
+#include <cstdint>
+#include <locale>
+#include <string>
+#include <benchmark/benchmark.h>
+#include "pypp/pypp.hpp"
+
+
+using benchmark::DoNotOptimize;
+using benchmark::State;
+using std::locale;
+using std::string;
+
+using namespace pypp;
+
+
+namespace {
+
+/// Generate printable ASCII text with mixed case.
+///
+/// @param size text length
+/// @return text
+string text(size_t size) {
+    string text(size, ' ');
+    uint32_t seed(12345);
+    for (auto& c: text) {
+        // Use a simple LCG for reproducible output.
+        seed = seed * 1103515245 + 12345;
+        c = static_cast<char>(' ' + (seed >> 16) % 95);
+    }
+    return text;
+}
+
+
+/// Generate lines of text.
+///
+/// @param size approximate text length
+/// @return text
+string lines(size_t size) {
+    string str;
+    const auto line(text(79));
+    while (str.size() < size) {
+        str += line + "\n";
+    }
+    return str;
+}
+
+}  // internal linkage
+
+
+/// Benchmark the per-character locale conversion that lower() used to do.
+///
+void BM_lower_locale(State& state) {
+    auto str(text(state.range(0)));
+    for (auto _: state) {
+        std::transform(str.begin(), str.end(), str.begin(), [](char c) {
+            return std::tolower(c, locale());
+        });
+        DoNotOptimize(str.data());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_lower_locale)->Arg(1 << 22);
+
+
+/// Benchmark the lower() function for a string.
+///
+void BM_lower(State& state) {
+    const auto str(text(state.range(0)));
+    for (auto _: state) {
+        DoNotOptimize(str::lower(str));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_lower)->Arg(64)->Arg(1 << 22);
+
+
+/// Benchmark the in-place lower() function.
+///
+void BM_lower_inplace(State& state) {
+    auto str(text(state.range(0)));
+    for (auto _: state) {
+        str::lower(&str[0], &str[0] + str.size());
+        DoNotOptimize(str.data());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_lower_inplace)->Arg(64)->Arg(1 << 22);
+
+
+/// Benchmark the in-place upper() function.
+///
+void BM_upper_inplace(State& state) {
+    auto str(text(state.range(0)));
+    for (auto _: state) {
+        str::upper(&str[0], &str[0] + str.size());
+        DoNotOptimize(str.data());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_upper_inplace)->Arg(64)->Arg(1 << 22);
+
+
+/// Benchmark the strip() function for long leading and trailing runs.
+///
+void BM_strip(State& state) {
+    const string pad(state.range(0), ' ');
+    const auto str(pad + "abc" + pad);
+    for (auto _: state) {
+        DoNotOptimize(str::strip(str));
+    }
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+BENCHMARK(BM_strip)->Arg(4)->Arg(1 << 10);
+
+
+/// Benchmark the strip() function for a set of characters.
+///
+void BM_strip_chars(State& state) {
+    const string pad(state.range(0), '0');
+    const auto str(pad + "abc" + pad);
+    static const string chars("0123456789");
+    for (auto _: state) {
+        DoNotOptimize(str::strip(str, chars));
+    }
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+BENCHMARK(BM_strip_chars)->Arg(4)->Arg(1 << 10);
+
+
+/// Benchmark the split() function for a separator.
+///
+void BM_split_sep(State& state) {
+    const auto str(text(state.range(0)));
+    for (auto _: state) {
+        DoNotOptimize(str::split(str, "a"));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_split_sep)->Arg(1 << 20);
+
+
+/// Benchmark the view split() function for a separator.
+///
+void BM_view_split_sep(State& state) {
+    const auto str(text(state.range(0)));
+    for (auto _: state) {
+        DoNotOptimize(str::view::split(str, "a"));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_view_split_sep)->Arg(1 << 20);
+
+
+/// Benchmark the isplit() function for a separator.
+///
+void BM_isplit_sep(State& state) {
+    const auto str(text(state.range(0)));
+    for (auto _: state) {
+        for (const auto item: str::isplit(str, "a")) {
+            DoNotOptimize(item);
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_isplit_sep)->Arg(1 << 20);
+
+
+/// Benchmark the isplit() function for whitespace.
+///
+void BM_isplit(State& state) {
+    const auto str(text(state.range(0)));
+    for (auto _: state) {
+        for (const auto item: str::isplit(str)) {
+            DoNotOptimize(item);
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_isplit)->Arg(1 << 20);
+
+
+/// Benchmark the split() function for lines as a baseline for splitlines().
+///
+void BM_split_lines(State& state) {
+    const auto str(lines(state.range(0)));
+    for (auto _: state) {
+        DoNotOptimize(str::split(str, "\n"));
+    }
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+BENCHMARK(BM_split_lines)->Arg(1 << 20);
+
+
+/// Benchmark the splitlines() function.
+///
+void BM_splitlines(State& state) {
+    const auto str(lines(state.range(0)));
+    for (auto _: state) {
+        DoNotOptimize(str::splitlines(str));
+    }
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+BENCHMARK(BM_splitlines)->Arg(1 << 20);
+
+
+/// Benchmark the isplitlines() function.
+///
+void BM_isplitlines(State& state) {
+    const auto str(lines(state.range(0)));
+    for (auto _: state) {
+        for (const auto line: str::isplitlines(str)) {
+            DoNotOptimize(line);
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+BENCHMARK(BM_isplitlines)->Arg(1 << 20);
+
+
+/// Benchmark the rsplit() function for a record with many fields.
+///
+/// The complexity of rsplit() should be linear in the number of fields.
+///
+void BM_rsplit_fields(State& state) {
+    string str;
+    for (auto i(0); i < state.range(0); ++i) {
+        str += "field,";
+    }
+    for (auto _: state) {
+        DoNotOptimize(str::rsplit(str, ","));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_rsplit_fields)->RangeMultiplier(4)->Range(1 << 10, 1 << 18)->Complexity(benchmark::oN);
+
+
+/// Benchmark the rsplit() function on whitespace for many fields.
+///
+void BM_rsplit_whitespace(State& state) {
+    string str;
+    for (auto i(0); i < state.range(0); ++i) {
+        str += "field ";
+    }
+    for (auto _: state) {
+        DoNotOptimize(str::rsplit(str));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_rsplit_whitespace)->RangeMultiplier(4)->Range(1 << 10, 1 << 18)->Complexity(benchmark::oN);
+
+
+/// Benchmark the irsplit() function for the last few fields of a record.
+///
+void BM_irsplit_last(State& state) {
+    string str;
+    for (auto i(0); i < state.range(0); ++i) {
+        str += "field,";
+    }
+    for (auto _: state) {
+        auto items(str::irsplit(str, ","));
+        auto item(items.begin());
+        for (auto i(0); i < 3; ++i, ++item) {
+            DoNotOptimize(*item);
+        }
+    }
+}
+BENCHMARK(BM_irsplit_last)->Arg(1 << 18);
+
+
+/// Benchmark the join() function for a vector of strings.
+///
+void BM_join(State& state) {
+    const std::vector<string> items(state.range(0), "field");
+    for (auto _: state) {
+        DoNotOptimize(str::join(items, ","));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_join)->Arg(1 << 20);
+
+
+/// Benchmark the join() function for a generator.
+///
+void BM_join_generator(State& state) {
+    string str;
+    for (auto i(0); i < state.range(0); ++i) {
+        str += "field ";
+    }
+    for (auto _: state) {
+        auto items(str::isplit(str));
+        DoNotOptimize(str::join(items.begin(), items.end(), ","));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_join_generator)->Arg(1 << 20);
+
+
+/// Benchmark the join() function with a buffer as output.
+///
+void BM_join_buffer(State& state) {
+    const std::vector<string> items(state.range(0), "field");
+    string buffer(items.size() * 6, '\0');
+    for (auto _: state) {
+        DoNotOptimize(str::join(&buffer[0], &buffer[0] + buffer.size(), items.begin(), items.end(), ","));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_join_buffer)->Arg(1 << 20);
+
+
+/// Benchmark the replace() function with a longer substitution.
+///
+void BM_replace(State& state) {
+    const auto str(text(state.range(0)));
+    for (auto _: state) {
+        DoNotOptimize(str::replace(str, "a", "&#97;"));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_replace)->Arg(1 << 20);
+
+
+/// Benchmark chained replace() calls for many patterns.
+///
+void BM_replace_chained(State& state) {
+    const auto str(text(state.range(0)));
+    std::vector<std::pair<string, string>> subs;
+    for (char c('A'); c <= 'Z'; ++c) {
+        subs.emplace_back(string(1, c) + "!", "<" + string(1, c) + ">");
+    }
+    for (auto _: state) {
+        auto result(str);
+        for (const auto& sub: subs) {
+            result = str::replace(result, sub.first, sub.second);
+        }
+        DoNotOptimize(result);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_replace_chained)->Arg(1 << 20);
+
+
+/// Benchmark the replace() function for many patterns at once.
+///
+void BM_replace_multi(State& state) {
+    const auto str(text(state.range(0)));
+    std::vector<std::pair<string, string>> subs;
+    for (char c('A'); c <= 'Z'; ++c) {
+        subs.emplace_back(string(1, c) + "!", "<" + string(1, c) + ">");
+    }
+    const str::Replacer replacer(subs);
+    for (auto _: state) {
+        DoNotOptimize(str::replace(str, replacer));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_replace_multi)->Arg(1 << 20);
+
+
+/// Benchmark the translate() function.
+///
+void BM_translate(State& state) {
+    const auto str(text(state.range(0)));
+    const auto table(str::maketrans("abc", "xyz", "!?"));
+    for (auto _: state) {
+        DoNotOptimize(str::translate(str, table));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_translate)->Arg(1 << 20);
+
+
+/// Benchmark std::string::find() as a baseline for find().
+///
+void BM_find_std(State& state) {
+    const auto str(text(1 << 22));
+    const string sub(str.substr(str.size() - state.range(0)));
+    for (auto _: state) {
+        DoNotOptimize(str.find(sub));
+    }
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+BENCHMARK(BM_find_std)->Arg(4)->Arg(16)->Arg(64)->Arg(256)->Arg(1024);
+
+
+/// Benchmark the find() function for short and long substrings.
+///
+/// The substring is at the end of the string, so the entire string has to be
+/// searched.
+///
+void BM_find(State& state) {
+    const auto str(text(1 << 22));
+    const string sub(str.substr(str.size() - state.range(0)));
+    for (auto _: state) {
+        DoNotOptimize(str::find(str, sub));
+    }
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+BENCHMARK(BM_find)->Arg(4)->Arg(16)->Arg(64)->Arg(256)->Arg(1024);
+
+
+/// Benchmark the rfind() function for short and long substrings.
+///
+void BM_rfind(State& state) {
+    const auto str(text(1 << 22));
+    const string sub(str.substr(0, state.range(0)));
+    for (auto _: state) {
+        DoNotOptimize(str::rfind(str, sub));
+    }
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+BENCHMARK(BM_rfind)->Arg(4)->Arg(16)->Arg(64)->Arg(256)->Arg(1024);
+
+
+/// Benchmark the count() function.
+///
+void BM_count(State& state) {
+    const auto str(text(1 << 22));
+    for (auto _: state) {
+        DoNotOptimize(str::count(str, "ab"));
+    }
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+BENCHMARK(BM_count);
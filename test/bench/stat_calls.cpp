@@ -0,0 +1,49 @@
+/// Replacement stat functions that count calls.
+///
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <atomic>
+#include "stat_calls.hpp"
+
+
+namespace {
+
+std::atomic<std::size_t> count(0);  ///< running count of stat() calls
+
+}  // internal linkage
+
+
+std::size_t stat_calls() {
+    return count.load();
+}
+
+
+extern "C" int stat(const char* path, struct stat* buf) noexcept {
+    ++count;
+    return fstatat(AT_FDCWD, path, buf, 0);
+}
+
+
+extern "C" int lstat(const char* path, struct stat* buf) noexcept {
+    ++count;
+    return fstatat(AT_FDCWD, path, buf, AT_SYMLINK_NOFOLLOW);
+}
+
+
+#if defined(__GLIBC__) and defined(__USE_LARGEFILE64)
+
+// With 64-bit file offsets on a 32-bit target, glibc redirects stat() and
+// lstat() to these.
+
+extern "C" int stat64(const char* path, struct stat64* buf) noexcept {
+    ++count;
+    return fstatat64(AT_FDCWD, path, buf, 0);
+}
+
+
+extern "C" int lstat64(const char* path, struct stat64* buf) noexcept {
+    ++count;
+    return fstatat64(AT_FDCWD, path, buf, AT_SYMLINK_NOFOLLOW);
+}
+
+#endif
@@ -0,0 +1,22 @@
+/// stat() call counting for benchmarks.
+///
+/// Linking stat_calls.cpp replaces the C library stat functions for the whole
+/// executable, so it is only linked into the instrumented benchmark runner,
+/// not the main one.
+///
+#ifndef PYPP_BENCH_STAT_CALLS_HPP
+#define PYPP_BENCH_STAT_CALLS_HPP
+
+#include <cstddef>
+
+
+/// Get the number of stat() calls so far.
+///
+/// Calls are only counted where the C library resolves them to one of the
+/// replaced symbols, e.g. not to __xstat() with glibc older than 2.33 or to
+/// stat$INODE64 on macOS, so callers need to check that the count changes.
+///
+/// @return running count of calls
+std::size_t stat_calls();
+
+#endif  // PYPP_BENCH_STAT_CALLS_HPP
@@ -0,0 +1,254 @@
+/// Test suite for the convert module.
+///
+/// Link all test files with the `gtest_main` library to create a command-line
+/// test runner.
+///
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <gtest/gtest.h>
+#include "pypp/pypp.hpp"
+
+
+using std::errc;
+using std::invalid_argument;
+using std::numeric_limits;
+using std::out_of_range;
+using std::string;
+using std::vector;
+
+using namespace pypp::convert;
+
+
+namespace {
+
+/// Parse a string with from_chars().
+///
+/// @param str string to parse
+/// @param value output value
+/// @return number of characters consumed, or -1 on error
+template <typename T>
+long parse_chars(const string& str, T& value) {
+    const auto result(from_chars(str.data(), str.data() + str.size(), value));
+    return result.ec == errc() ? result.ptr - str.data() : -1;
+}
+
+}  // internal linkage
+
+
+/// Test the from_chars() function for integers.
+///
+TEST(convert, from_chars_int)
+{
+    long long value(0);
+    ASSERT_EQ(parse_chars("12345678901234567", value), 17);
+    ASSERT_EQ(value, 12345678901234567);
+    ASSERT_EQ(parse_chars("-42abc", value), 3);
+    ASSERT_EQ(value, -42);
+    ASSERT_EQ(parse_chars("0000000000000000000000007", value), 25);
+    ASSERT_EQ(value, 7);
+    ASSERT_EQ(parse_chars("9223372036854775807", value), 19);
+    ASSERT_EQ(value, numeric_limits<long long>::max());
+    ASSERT_EQ(parse_chars("-9223372036854775808", value), 20);
+    ASSERT_EQ(value, numeric_limits<long long>::min());
+    for (const auto str: {"", "-", "+1", " 1", "abc"}) {
+        ASSERT_EQ(parse_chars(str, value), -1);
+    }
+    const string big("9223372036854775808");
+    const auto result(from_chars(big.data(), big.data() + big.size(), value));
+    ASSERT_EQ(result.ec, errc::result_out_of_range);
+    ASSERT_EQ(result.ptr, big.data() + big.size());
+    ASSERT_EQ(value, numeric_limits<long long>::min());  // unchanged
+}
+
+
+/// Test the from_chars() function for other integer types.
+///
+TEST(convert, from_chars_types)
+{
+    int small(0);
+    ASSERT_EQ(parse_chars("-2147483648", small), 11);
+    ASSERT_EQ(small, numeric_limits<int>::min());
+    ASSERT_EQ(parse_chars("2147483648", small), -1);
+    unsigned long long big(0);
+    ASSERT_EQ(parse_chars("18446744073709551615", big), 20);
+    ASSERT_EQ(big, numeric_limits<unsigned long long>::max());
+    ASSERT_EQ(parse_chars("18446744073709551616", big), -1);
+    ASSERT_EQ(parse_chars("184467440737095516150", big), -1);
+    ASSERT_EQ(parse_chars("-1", big), -1);
+    unsigned mid(0);
+    ASSERT_EQ(parse_chars("4294967295", mid), 10);
+    ASSERT_EQ(mid, numeric_limits<unsigned>::max());
+}
+
+
+/// Test the from_chars() function for floating point numbers.
+///
+TEST(convert, from_chars_float)
+{
+    double value(0);
+    ASSERT_EQ(parse_chars("0.1", value), 3);
+    ASSERT_EQ(value, 0.1);
+    ASSERT_EQ(parse_chars("-1.5e3x", value), 6);
+    ASSERT_EQ(value, -1500.);
+    ASSERT_EQ(parse_chars(".5", value), 2);
+    ASSERT_EQ(value, 0.5);
+    ASSERT_EQ(parse_chars("5.", value), 2);
+    ASSERT_EQ(value, 5.);
+    ASSERT_EQ(parse_chars("1e", value), 1);
+    ASSERT_EQ(value, 1.);
+    ASSERT_EQ(parse_chars("-0", value), 2);
+    ASSERT_TRUE(value == 0 and std::signbit(value));
+    ASSERT_EQ(parse_chars("1.7976931348623157e308", value), 22);
+    ASSERT_EQ(value, numeric_limits<double>::max());
+    ASSERT_EQ(parse_chars("4.9406564584124654e-324", value), 23);
+    ASSERT_EQ(value, numeric_limits<double>::denorm_min());
+    ASSERT_EQ(parse_chars("123456789012345678901234567890", value), 30);
+    ASSERT_EQ(value, 123456789012345678901234567890.);
+    ASSERT_EQ(parse_chars("-Infinity", value), 9);
+    ASSERT_EQ(value, -numeric_limits<double>::infinity());
+    ASSERT_EQ(parse_chars("inf", value), 3);
+    ASSERT_EQ(value, numeric_limits<double>::infinity());
+    ASSERT_EQ(parse_chars("NaN", value), 3);
+    ASSERT_TRUE(std::isnan(value));
+    for (const auto str: {"", "-", ".", "e5", "+1", "in"}) {
+        ASSERT_EQ(parse_chars(str, value), -1);
+    }
+    ASSERT_EQ(parse_chars("1e999", value), -1);
+    ASSERT_EQ(parse_chars("1e-999", value), -1);
+    float single(0);
+    ASSERT_EQ(parse_chars("0.1", single), 3);
+    ASSERT_EQ(single, 0.1f);
+    ASSERT_EQ(parse_chars("3.4028235e38", single), 12);
+    ASSERT_EQ(single, numeric_limits<float>::max());
+}
+
+
+/// Test the from_chars() function against the C library.
+///
+TEST(convert, from_chars_float_random)
+{
+    std::uint64_t seed(12345);
+    for (auto i(0); i < 10000; ++i) {
+        // Generate random bit patterns for finite doubles.
+        seed = seed * 6364136223846793005 + 1442695040888963407;
+        double expected;
+        std::memcpy(&expected, &seed, sizeof(expected));
+        if (not std::isfinite(expected)) {
+            continue;
+        }
+        char str[32];
+        std::snprintf(str, sizeof(str), "%.17g", expected);
+        double value;
+        ASSERT_EQ(parse_chars(str, value), static_cast<long>(std::strlen(str)));
+        ASSERT_EQ(value, expected) << str;
+    }
+}
+
+
+/// Test the to_chars() function for integers.
+///
+TEST(convert, to_chars_int)
+{
+    char buffer[24];
+    const auto result(to_chars(buffer, buffer + sizeof(buffer), -1234567));
+    ASSERT_EQ(result.ec, errc());
+    ASSERT_EQ(string(buffer, result.ptr), "-1234567");
+    ASSERT_EQ(to_chars(buffer, buffer + 3, 1234).ec, errc::value_too_large);
+    ASSERT_EQ(to_str(0), "0");
+    ASSERT_EQ(to_str(numeric_limits<long long>::min()), "-9223372036854775808");
+    ASSERT_EQ(to_str(numeric_limits<unsigned long long>::max()), "18446744073709551615");
+    ASSERT_EQ(to_str(10u), "10");
+}
+
+
+/// Test the to_chars() function for floating point numbers.
+///
+TEST(convert, to_chars_float)
+{
+    ASSERT_EQ(to_str(0.1), "0.1");
+    ASSERT_EQ(to_str(1.), "1.0");
+    ASSERT_EQ(to_str(-0.), "-0.0");
+    ASSERT_EQ(to_str(100.), "100.0");
+    ASSERT_EQ(to_str(1.5e-4), "0.00015");
+    ASSERT_EQ(to_str(1e-5), "1e-05");
+    ASSERT_EQ(to_str(1e16), "1e+16");
+    ASSERT_EQ(to_str(1234567890123456.), "1234567890123456.0");
+    ASSERT_EQ(to_str(0.1 + 0.2), "0.30000000000000004");
+    ASSERT_EQ(to_str(1.7976931348623157e308), "1.7976931348623157e+308");
+    ASSERT_EQ(to_str(5e-324), "5e-324");
+    ASSERT_EQ(to_str(numeric_limits<double>::infinity()), "inf");
+    ASSERT_EQ(to_str(-numeric_limits<double>::infinity()), "-inf");
+    ASSERT_EQ(to_str(numeric_limits<double>::quiet_NaN()), "nan");
+    ASSERT_EQ(to_str(0.1f), "0.1");
+    ASSERT_EQ(to_str(16777216.f), "16777216.0");
+    char buffer[4];
+    ASSERT_EQ(to_chars(buffer, buffer + sizeof(buffer), 0.125).ec, errc::value_too_large);
+}
+
+
+/// Test that to_chars() output round trips through from_chars().
+///
+TEST(convert, to_chars_float_random)
+{
+    std::uint64_t seed(12345);
+    for (auto i(0); i < 10000; ++i) {
+        seed = seed * 6364136223846793005 + 1442695040888963407;
+        double expected;
+        std::memcpy(&expected, &seed, sizeof(expected));
+        if (not std::isfinite(expected)) {
+            continue;
+        }
+        const auto str(to_str(expected));
+        double value;
+        ASSERT_EQ(parse_chars(str, value), static_cast<long>(str.size()));
+        ASSERT_EQ(value, expected) << str;
+    }
+}
+
+
+/// Test the to_int() function.
+///
+TEST(convert, to_int)
+{
+    ASSERT_EQ(to_int(" +42\n"), 42);
+    ASSERT_EQ(to_int("-7"), -7);
+    ASSERT_THROW(to_int("4 2"), invalid_argument);
+    ASSERT_THROW(to_int("+-1"), invalid_argument);
+    ASSERT_THROW(to_int("1.0"), invalid_argument);
+    ASSERT_THROW(to_int(""), invalid_argument);
+    ASSERT_THROW(to_int("99999999999999999999"), out_of_range);
+}
+
+
+/// Test the to_float() function.
+///
+TEST(convert, to_float)
+{
+    ASSERT_EQ(to_float(" 1.25 "), 1.25);
+    ASSERT_EQ(to_float("+1e3"), 1000.);
+    ASSERT_EQ(to_float("-inf"), -numeric_limits<double>::infinity());
+    ASSERT_THROW(to_float("1.0x"), invalid_argument);
+    ASSERT_THROW(to_float("1e400"), out_of_range);
+}
+
+
+/// Test the parse_fields() function.
+///
+TEST(convert, parse_fields)
+{
+    ASSERT_EQ(parse_fields<int>("1, 2,3 ", ","), vector<int>({1, 2, 3}));
+    ASSERT_EQ(parse_fields<double>(" 1.5\t-2 1e3\n"), vector<double>({1.5, -2., 1000.}));
+    ASSERT_EQ(parse_fields<double>(""), vector<double>());
+    ASSERT_THROW(parse_fields<int>("1,,3", ","), invalid_argument);
+    double values[2];
+    const auto end(parse_fields<double>("0.5;0.25", ";", values));
+    ASSERT_EQ(end, values + 2);
+    ASSERT_EQ(values[1], 0.25);
+}
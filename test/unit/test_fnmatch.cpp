@@ -0,0 +1,173 @@
+/// Test suite for the fnmatch module.
+///
+/// Link all test files with the `gtest_main` library to create a command line
+/// test runner.
+///
+#include <list>
+#include <regex>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <gtest/gtest.h>
+#include "pypp/pypp.hpp"
+
+
+using std::list;
+using std::make_tuple;
+using std::regex;
+using std::string;
+using std::tuple;
+using std::vector;
+using testing::TestWithParam;
+using testing::Values;
+
+using namespace pypp::fnmatch;
+
+
+/// Test fixture for matching a single pattern.
+///
+/// The test parameter is a name, a pattern, and the expected result. Most of
+/// these cases are from the Python fnmatch test suite.
+///
+class MatchTest: public TestWithParam<tuple<string, string, bool>> {};
+
+
+/// Test the fnmatchcase() function.
+///
+TEST_P(MatchTest, fnmatchcase)
+{
+    const auto& name(std::get<0>(GetParam()));
+    const auto& pattern(std::get<1>(GetParam()));
+    ASSERT_EQ(std::get<2>(GetParam()), fnmatchcase(name, pattern));
+    ASSERT_EQ(std::get<2>(GetParam()), Pattern(pattern).match(name));
+}
+
+
+/// Test the translate() function.
+///
+TEST_P(MatchTest, translate)
+{
+    const auto& name(std::get<0>(GetParam()));
+    const auto& pattern(std::get<1>(GetParam()));
+    ASSERT_EQ(std::get<2>(GetParam()), std::regex_match(name, regex(translate(pattern))));
+}
+
+
+INSTANTIATE_TEST_CASE_P(fnmatch, MatchTest, Values(
+    make_tuple("abc", "abc", true),
+    make_tuple("abc", "?*?", true),
+    make_tuple("abc", "???*", true),
+    make_tuple("abc", "*???", true),
+    make_tuple("abc", "???", true),
+    make_tuple("abc", "*", true),
+    make_tuple("abc", "ab[cd]", true),
+    make_tuple("abc", "ab[!de]", true),
+    make_tuple("abc", "ab[de]", false),
+    make_tuple("a", "??", false),
+    make_tuple("a", "b", false),
+    make_tuple("", "", true),
+    make_tuple("", "*", true),
+    make_tuple("a", "", false),
+    make_tuple("\\", "[\\]", true),
+    make_tuple("a", "[!\\]", true),
+    make_tuple("\\", "[!\\]", false),
+    make_tuple("foo\nbar", "foo*", true),
+    make_tuple("foo\nbar\n", "foo*", true),
+    make_tuple("\nfoo", "foo*", false),
+    make_tuple("\n", "*", true),
+    make_tuple("a/.b", "a*b", true),
+    make_tuple("[", "[", true),
+    make_tuple("[a", "[a", true),
+    make_tuple("[", "[[]", true),
+    make_tuple("]", "[]]", true),
+    make_tuple("a", "[!]]", true),
+    make_tuple("]", "[!]]", false),
+    make_tuple("-", "[a-]", true),
+    make_tuple("b", "[a-c]", true),
+    make_tuple("b", "[c-a]", false),
+    make_tuple("a.b", "a.*", true),
+    make_tuple("a+b", "a+b", true),
+    make_tuple("a(b)", "a(*)", true),
+    make_tuple("\x80\xff", "[\x80-\xff]?", true),
+    make_tuple("abcbcd", "*bc*cd", true),
+    make_tuple("abcbc", "*bc*cd", false),
+    make_tuple("ABC", "abc", false),
+    make_tuple("mississippi", "*s*s*ip*", true),
+    make_tuple("mississippi", "*ss*ss*ss*", false)
+));
+
+
+/// Test the fnmatch() function.
+///
+TEST(fnmatch, fnmatch)
+{
+    ASSERT_TRUE(fnmatch("abc.txt", "*.txt"));
+    ASSERT_FALSE(fnmatch("abc.dat", "*.txt"));
+#if defined(_WIN32)
+    ASSERT_TRUE(fnmatch("ABC.TXT", "*.txt"));
+#else
+    ASSERT_FALSE(fnmatch("ABC.TXT", "*.txt"));
+#endif
+}
+
+
+/// Test matching without regard to case.
+///
+TEST(fnmatch, ignore_case)
+{
+    const Pattern pattern("ab[c-e]*.TXT", true);
+    ASSERT_TRUE(pattern.match("abc.txt"));
+    ASSERT_TRUE(pattern.match("ABD1.Txt"));
+    ASSERT_FALSE(pattern.match("abf.txt"));
+    ASSERT_TRUE(Pattern("[!a]", true).match("b"));
+    ASSERT_FALSE(Pattern("[!a]", true).match("A"));
+}
+
+
+/// Test matching a set of patterns.
+///
+TEST(fnmatch, Pattern_set)
+{
+    const Pattern patterns({"*.tmp", "build/*", "*.o", "*"});
+    ASSERT_EQ(4u, patterns.size());
+    ASSERT_EQ(0, patterns.find("a.tmp"));
+    ASSERT_EQ(0, patterns.find("build/a.tmp"));  // first match
+    ASSERT_EQ(1, patterns.find("build/a.o"));
+    ASSERT_EQ(2, patterns.find("a.o"));
+    ASSERT_EQ(3, patterns.find("a.c"));
+    const Pattern excludes(vector<string>({"*.tmp", "*~"}));
+    ASSERT_TRUE(excludes.match("a~"));
+    ASSERT_FALSE(excludes.match("a.c"));
+    ASSERT_EQ(-1, excludes.find("a.c"));
+    const Pattern empty(vector<string>{});
+    ASSERT_EQ(0u, empty.size());
+    ASSERT_FALSE(empty.match(""));
+}
+
+
+/// Test a pattern whose automaton is too large to build.
+///
+TEST(fnmatch, Pattern_large)
+{
+    // The deterministic automaton for this pattern needs 2^20 states.
+    const auto pattern("*a" + string(19, '?'));
+    const Pattern compiled(pattern);
+    ASSERT_TRUE(compiled.match("xyz" + string(20, 'a')));
+    ASSERT_TRUE(compiled.match("a" + string(19, 'b')));
+    ASSERT_FALSE(compiled.match(string(20, 'b')));
+    ASSERT_FALSE(compiled.match("a" + string(18, 'b')));
+}
+
+
+/// Test the filter() function.
+///
+TEST(fnmatch, filter)
+{
+    const vector<string> names({"a.txt", "b.dat", "c.txt"});
+    ASSERT_EQ(vector<string>({"a.txt", "c.txt"}), filter(names, "*.txt"));
+    const list<string> items(names.begin(), names.end());
+    ASSERT_EQ(vector<string>({"b.dat"}), filter(items.begin(), items.end(), "*.dat"));
+    const Pattern pattern({"a*", "b*"});
+    ASSERT_EQ(vector<string>({"a.txt", "b.dat"}), filter(items.begin(), items.end(), pattern));
+    ASSERT_TRUE(filter(names, "*.csv").empty());
+}
@@ -0,0 +1,177 @@
+/// Test suite for the glob module.
+///
+/// Link all test files with the `gtest_main` library to create a command line
+/// test runner.
+///
+#include <unistd.h>  // symlink
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "pypp/pypp.hpp"
+
+
+using pypp::os::makedirs;
+using pypp::path::join;
+using pypp::tempfile::TemporaryDirectory;
+using std::fstream;
+using std::set;
+using std::string;
+using std::vector;
+using testing::Test;
+
+using namespace pypp::glob;
+
+
+/// Test fixture for the glob module.
+///
+class GlobTest: public Test
+{
+protected:
+    /// Create a directory tree.
+    ///
+    /// The tree contains hidden files and directories, and a symbolic link to
+    /// a directory.
+    ///
+    void SetUp() override {
+        makedirs(join({root, "dir1", "sub"}));
+        makedirs(join({root, "dir2"}));
+        makedirs(join({root, ".hdir"}));
+        for (const auto file: {"a.txt", "b.txt", "c.dat", ".hidden.txt", "dir1/x.txt",
+                               "dir1/sub/y.txt", "dir2/z.txt", ".hdir/w.txt"}) {
+            fstream(join({root, file}), fstream::out);
+        }
+        symlink("dir1", join({root, "link"}).c_str());
+        return;
+    }
+
+    /// Get the matches for a pattern relative to the tree root.
+    ///
+    /// @param pattern relative pattern
+    /// @param recursive `**` matches any number of directories
+    /// @param threads number of threads
+    /// @return matching paths relative to the tree root
+    vector<string> matches(const string& pattern, bool recursive=false, size_t threads=1) const {
+        const auto base(escape(root) + '/');
+        vector<string> paths;
+        for (const auto& path: glob(base + pattern, recursive, threads)) {
+            paths.emplace_back(path.substr(base.size()));
+        }
+        return paths;
+    }
+
+    const TemporaryDirectory tmpdir;
+    const string root{tmpdir.name()};
+};
+
+
+/// Test the glob() function for literal patterns.
+///
+TEST_F(GlobTest, glob_literal)
+{
+    ASSERT_EQ(vector<string>({"a.txt"}), matches("a.txt"));
+    ASSERT_EQ(vector<string>({"dir1/sub/y.txt"}), matches("dir1/sub/y.txt"));
+    ASSERT_EQ(vector<string>({"link"}), matches("link"));
+    ASSERT_TRUE(matches("missing").empty());
+    ASSERT_TRUE(matches("a.txt/missing").empty());
+    ASSERT_TRUE(glob("").empty());
+    ASSERT_EQ(vector<string>({"/"}), glob("/"));
+}
+
+
+/// Test the glob() function for wildcard patterns.
+///
+TEST_F(GlobTest, glob_wildcard)
+{
+    ASSERT_EQ(vector<string>({"a.txt", "b.txt"}), matches("*.txt"));
+    ASSERT_EQ(vector<string>({"c.dat"}), matches("?.dat"));
+    ASSERT_EQ(vector<string>({"a.txt", "b.txt", "c.dat"}), matches("*.*"));
+    ASSERT_EQ(vector<string>({".hdir", ".hidden.txt"}), matches(".*"));
+    ASSERT_EQ(vector<string>({".hdir/w.txt"}), matches(".h*/*"));
+    ASSERT_EQ(vector<string>({"dir1/x.txt", "dir2/z.txt", "link/x.txt"}), matches("*/*.txt"));
+    ASSERT_EQ(vector<string>({"dir1/sub/y.txt"}), matches("d*/*/*"));
+    ASSERT_TRUE(matches("*.csv").empty());
+    ASSERT_TRUE(matches("missing/*").empty());
+}
+
+
+/// Test the glob() function for character sets.
+///
+TEST_F(GlobTest, glob_set)
+{
+    ASSERT_EQ(vector<string>({"a.txt", "b.txt"}), matches("[ab].txt"));
+    ASSERT_EQ(vector<string>({"b.txt"}), matches("[!a].txt"));
+    ASSERT_EQ(vector<string>({"a.txt", "b.txt", "c.dat"}), matches("[a-c].*"));
+    ASSERT_TRUE(matches("[c-a].*").empty());  // empty range
+    ASSERT_EQ(vector<string>({"dir1", "dir2"}), matches("dir[0-9]"));
+    fstream(join({root, "[x"}), fstream::out);
+    fstream(join({root, "]"}), fstream::out);
+    ASSERT_EQ(vector<string>({"[x"}), matches("[x"));  // unterminated
+    ASSERT_EQ(vector<string>({"[x"}), matches("[[]*"));
+    ASSERT_EQ(vector<string>({"]"}), matches("[]]"));
+}
+
+
+/// Test the glob() function for directory patterns.
+///
+TEST_F(GlobTest, glob_dironly)
+{
+    ASSERT_EQ(vector<string>({"dir1/", "dir2/", "link/"}), matches("*/"));
+    ASSERT_EQ(vector<string>({"dir1/"}), matches("dir1/"));
+    ASSERT_TRUE(matches("a.txt/").empty());
+}
+
+
+/// Test the glob() function for recursive patterns.
+///
+TEST_F(GlobTest, glob_recursive)
+{
+    const vector<string> txt({"a.txt", "b.txt", "dir1/sub/y.txt", "dir1/x.txt", "dir2/z.txt"});
+    ASSERT_EQ(txt, matches("**/*.txt", true));
+    ASSERT_EQ(txt, matches("**/**/*.txt", true));
+    ASSERT_EQ(txt, matches("**/*.txt", true, 4));
+    ASSERT_EQ(matches("*/*.txt"), matches("**/*.txt", false));
+    const vector<string> all({"dir1/sub", "dir1/sub/y.txt", "dir1/x.txt"});
+    ASSERT_EQ(all, matches("dir1/**", true));
+    ASSERT_EQ(all, matches("dir1/**", true, 4));
+    ASSERT_EQ(vector<string>({"dir1/sub/"}), matches("dir1/**/", true));
+    ASSERT_EQ(vector<string>({"dir1/sub/y.txt"}), matches("**/sub/*", true, 4));
+}
+
+
+/// Test the iglob() function.
+///
+TEST_F(GlobTest, iglob)
+{
+    for (const auto pattern: {"*", "*/*.txt", "**/*.txt", "dir1/**", "missing/*"}) {
+        const auto pattern_(escape(root) + '/' + pattern);
+        const auto expected(glob(pattern_, true));
+        set<string> paths;
+        for (const auto& path: iglob(pattern_, true)) {
+            ASSERT_TRUE(paths.insert(path).second);  // no duplicates
+        }
+        ASSERT_EQ(set<string>(expected.begin(), expected.end()), paths);
+    }
+}
+
+
+/// Test the escape() function.
+///
+TEST(glob, escape)
+{
+    ASSERT_EQ("abc/def", escape("abc/def"));
+    ASSERT_EQ("[*]a[?]b[[]c]", escape("*a?b[c]"));
+}
+
+
+/// Test the has_magic() function.
+///
+TEST(glob, has_magic)
+{
+    ASSERT_FALSE(has_magic("abc/def"));
+    ASSERT_FALSE(has_magic("abc]"));
+    for (const auto pattern: {"*", "a?", "[abc]"}) {
+        ASSERT_TRUE(has_magic(pattern));
+    }
+}
@@ -5,7 +5,9 @@
  * test runner.
  */
 #include <unistd.h>  // chdir
+#include <algorithm>
 #include <fstream>
+#include <mutex>
 #include <set>
 #include <stdexcept>
 #include <string>
@@ -17,6 +19,8 @@
 using pypp::path::abspath;
 using pypp::path::dirname;
 using pypp::path::isdir;
+using pypp::path::isfile;
+using pypp::path::islink;
 using pypp::path::join;
 using pypp::path::split;
 using pypp::tempfile::TemporaryDirectory;
@@ -87,6 +91,85 @@ TEST(os, listdir) {
 }
 
 
+/**
+ * Test the os::scandir() function.
+ */
+TEST(os, scandir) {
+    const TemporaryDirectory tmpdir;
+    const auto fname(join({tmpdir.name(), "file"}));
+    fstream(fname, fstream::out) << "abc";
+    makedirs(join({tmpdir.name(), "dir"}), 0700);
+    symlink("dir", join({tmpdir.name(), "link"}).c_str());
+    symlink("missing", join({tmpdir.name(), "broken"}).c_str());
+    set<string> names;
+    for (const auto& entry: scandir(tmpdir.name())) {
+        names.insert(entry.name());
+        ASSERT_EQ(entry.path(), join({tmpdir.name(), entry.name()}));
+        ASSERT_EQ(entry.inode(), entry.stat(false).st_ino);
+        if (entry.name() == "file") {
+            ASSERT_TRUE(entry.is_file() and not entry.is_dir() and not entry.is_symlink());
+            ASSERT_EQ(entry.stat().st_size, 3);
+            ASSERT_TRUE(isfile(entry.stat()));
+        }
+        else if (entry.name() == "dir") {
+            ASSERT_TRUE(entry.is_dir() and not entry.is_file() and not entry.is_symlink());
+        }
+        else if (entry.name() == "link") {
+            ASSERT_TRUE(entry.is_symlink() and entry.is_dir() and not entry.is_dir(false));
+            ASSERT_TRUE(isdir(entry.stat()) and islink(entry.stat(false)));
+        }
+        else {
+            ASSERT_TRUE(entry.is_symlink() and not entry.is_dir() and not entry.is_file());
+            ASSERT_THROW(entry.stat(), runtime_error);
+        }
+    }
+    ASSERT_EQ(set<string>({"broken", "dir", "file", "link"}), names);
+    ASSERT_THROW(scandir(fname), runtime_error);
+}
+
+
+/**
+ * Test the os::scandir() function for a large directory.
+ */
+TEST(os, scandir_large) {
+    static const size_t count(5000);  // more than one buffer
+    const TemporaryDirectory tmpdir;
+    for (size_t i(0); i < count; ++i) {
+        fstream(join({tmpdir.name(), std::to_string(i)}), fstream::out);
+    }
+    set<string> names;
+    for (const auto& entry: scandir(tmpdir.name())) {
+        ASSERT_TRUE(entry.is_file());
+        names.insert(entry.name());
+    }
+    ASSERT_EQ(names.size(), count);
+}
+
+
+/**
+ * Test the os::stat() and os::lstat() functions.
+ */
+TEST(os, stat) {
+    const TemporaryDirectory tmpdir;
+    const auto fname(join({tmpdir.name(), "file"}));
+    fstream(fname, fstream::out) << "abcd";
+    const auto link(join({tmpdir.name(), "link"}));
+    symlink("file", link.c_str());
+    const auto status(stat(fname));
+    ASSERT_EQ(status.st_size, 4);
+    ASSERT_TRUE(S_ISREG(status.st_mode));
+    ASSERT_EQ(status.st_nlink, 1);
+    ASSERT_GE(status.st_ctime_ns, status.st_mtime_ns);
+    ASSERT_EQ(stat(link).st_ino, status.st_ino);
+    ASSERT_TRUE(S_ISLNK(lstat(link).st_mode));
+    ASSERT_TRUE(S_ISLNK(stat(link, false).st_mode));
+    for (const auto& entry: scandir(tmpdir.name())) {
+        ASSERT_EQ(entry.inode(), lstat(entry.path()).st_ino);
+    }
+    ASSERT_THROW(stat(join({tmpdir.name(), "missing"})), runtime_error);
+}
+
+
 /**
  * Test the os::makedirs() function.
  */
@@ -99,6 +182,12 @@ TEST(os, makedirs) {
     makedirs(path, mode, true);   // exist_ok, no op
     ASSERT_TRUE(isdir(path));
     ASSERT_THROW(makedirs(path), runtime_error);  // not exist_ok
+    const auto cwd(getcwd());
+    chdir(tmpdir.name());
+    makedirs(join({"def", "..", "ghi"}), mode);  // creates "def" as in Python
+    const auto created(isdir("def") and isdir("ghi"));
+    chdir(cwd);
+    ASSERT_TRUE(created);
 }
 
 
@@ -106,17 +195,211 @@ TEST(os, makedirs) {
  * Test the os::removedirs() function.
  */
 TEST(os, removedirs) {
-    static const vector<string> subdirs({"abc", "xyz"});
     TemporaryDirectory tmpdir;
-    auto path(tmpdir.name());
-    for (const auto& dir: subdirs) {
-        // Create subdirectories to remove.
-        makedirs(join({path, dir}), 0700);
-    }
-    removedirs(path);  // will also remove tmpdir itself
-    const auto pair(split(tmpdir.name()));
-    ASSERT_TRUE(isdir(pair.first));
-    ASSERT_FALSE(isdir(pair.second));
+    fstream stream(join({tmpdir.name(), "file"}), fstream::out);  // not empty
+    const auto path(join({tmpdir.name(), "abc", "xyz"}));
+    makedirs(path, 0700);
+    removedirs(path + "/");
+    ASSERT_FALSE(isdir(join({tmpdir.name(), "abc"})));
+    ASSERT_TRUE(isdir(tmpdir.name()));
     removedirs(path);  // no op
-    ASSERT_TRUE(isdir(pair.first));
+    ASSERT_TRUE(isdir(tmpdir.name()));
+}
+
+
+/**
+ * Test fixture for the walk() functions.
+ *
+ * This creates a directory tree with a symbolic link to a subdirectory.
+ */
+class WalkTest: public Test
+{
+protected:
+    WalkTest() {
+        makedirs(join({tmpdir.name(), "a", "b"}), 0700);
+        makedirs(join({tmpdir.name(), "c"}), 0700);
+        fstream(join({tmpdir.name(), "f"}), fstream::out);
+        fstream(join({tmpdir.name(), "a", "1"}), fstream::out);
+        fstream(join({tmpdir.name(), "a", "b", "2"}), fstream::out);
+        symlink("a", join({tmpdir.name(), "link"}).c_str());
+    }
+
+    /**
+     * Return the relative paths of all entries in a walk() result.
+     *
+     * @param entry: walk() result
+     * @param paths: output paths; directories have a trailing separator
+     */
+    void relative(const WalkEntry& entry, set<string>& paths) const {
+        const auto root(entry.dirpath.substr(tmpdir.name().size()));
+        for (const auto& name: entry.dirnames) {
+            paths.insert(root + "/" + name + "/");
+        }
+        for (const auto& name: entry.filenames) {
+            paths.insert(root + "/" + name);
+        }
+    }
+
+    const TemporaryDirectory tmpdir;
+};
+
+
+/**
+ * Test the os::walk() function.
+ */
+TEST_F(WalkTest, walk) {
+    vector<string> dirpaths;
+    set<string> paths;
+    for (const auto& entry: walk(tmpdir.name())) {
+        const auto parent(dirname(entry.dirpath));
+        if (not dirpaths.empty()) {
+            // Parent directories are generated first.
+            ASSERT_NE(std::find(dirpaths.begin(), dirpaths.end(), parent), dirpaths.end());
+        }
+        dirpaths.emplace_back(entry.dirpath);
+        relative(entry, paths);
+    }
+    ASSERT_EQ(dirpaths.size(), 4);  // link is not followed
+    ASSERT_EQ(dirpaths.front(), tmpdir.name());
+    const set<string> expected({"/a/", "/a/1", "/a/b/", "/a/b/2", "/c/", "/f", "/link/"});
+    ASSERT_EQ(paths, expected);
+}
+
+
+/**
+ * Test the os::walk() function with pruning.
+ */
+TEST_F(WalkTest, walk_prune) {
+    auto tree(walk(tmpdir.name()));
+    set<string> dirpaths;
+    for (const auto& entry: tree) {
+        dirpaths.insert(entry.dirpath);
+        auto& dirnames(tree.dirnames());
+        dirnames.erase(std::remove(dirnames.begin(), dirnames.end(), "a"), dirnames.end());
+    }
+    ASSERT_EQ(dirpaths, set<string>({tmpdir.name(), join({tmpdir.name(), "c"})}));
+}
+
+
+/**
+ * Test the os::walk() function for a bottom-up walk.
+ */
+TEST_F(WalkTest, walk_bottomup) {
+    vector<string> dirpaths;
+    set<string> paths;
+    for (const auto& entry: walk(tmpdir.name(), false)) {
+        for (const auto& name: entry.dirnames) {
+            if (name == "link") {
+                continue;
+            }
+            // Child directories are generated first.
+            const auto child(join({entry.dirpath, name}));
+            ASSERT_NE(std::find(dirpaths.begin(), dirpaths.end(), child), dirpaths.end());
+        }
+        dirpaths.emplace_back(entry.dirpath);
+        relative(entry, paths);
+    }
+    ASSERT_EQ(dirpaths.size(), 4);
+    ASSERT_EQ(dirpaths.back(), tmpdir.name());
+    const set<string> expected({"/a/", "/a/1", "/a/b/", "/a/b/2", "/c/", "/f", "/link/"});
+    ASSERT_EQ(paths, expected);
+}
+
+
+/**
+ * Test the os::walk() function with symbolic links and errors.
+ */
+TEST_F(WalkTest, walk_options) {
+    set<string> dirpaths;
+    for (const auto& entry: walk(tmpdir.name(), true, nullptr, true)) {
+        dirpaths.insert(entry.dirpath);
+    }
+    ASSERT_EQ(dirpaths.size(), 6);  // link and link/b
+    ASSERT_EQ(dirpaths.count(join({tmpdir.name(), "link", "b"})), 1);
+    size_t errors(0);
+    const auto onerror([&errors](const runtime_error&) { ++errors; });
+    const auto missing(join({tmpdir.name(), "missing"}));
+    ASSERT_EQ(walk(missing, true, onerror).active(), false);
+    ASSERT_EQ(walk(missing, false, onerror).active(), false);
+    ASSERT_EQ(errors, 2);
+    ASSERT_EQ(walk(missing).active(), false);  // errors are ignored
+}
+
+
+/**
+ * Test the os::walk_parallel() function.
+ */
+TEST_F(WalkTest, walk_parallel) {
+    std::mutex mutex;
+    set<string> paths;
+    set<string> dirpaths;
+    walk_parallel(tmpdir.name(), [&](WalkEntry& entry) {
+        std::lock_guard<std::mutex> lock(mutex);
+        dirpaths.insert(entry.dirpath);
+        relative(entry, paths);
+    }, nullptr, false, 4);
+    const set<string> expected({"/a/", "/a/1", "/a/b/", "/a/b/2", "/c/", "/f", "/link/"});
+    ASSERT_EQ(paths, expected);
+    ASSERT_EQ(dirpaths.size(), 4);
+    dirpaths.clear();
+    walk_parallel(tmpdir.name(), [&](WalkEntry& entry) {
+        std::lock_guard<std::mutex> lock(mutex);
+        dirpaths.insert(entry.dirpath);
+        entry.dirnames.clear();  // prune everything
+    });
+    ASSERT_EQ(dirpaths, set<string>({tmpdir.name()}));
+    const auto callback([](WalkEntry& entry) {
+        if (entry.dirpath.back() == 'b') {
+            throw runtime_error("callback error");
+        }
+    });
+    ASSERT_THROW(walk_parallel(tmpdir.name(), callback), runtime_error);
+}
+
+
+/**
+ * Test the os::stat_many() function.
+ *
+ * The io_uring implementation is tested if the kernel supports it, and the
+ * thread pool fallback is tested by disabling it.
+ */
+TEST(os, stat_many) {
+    const TemporaryDirectory tmpdir;
+    vector<string> paths;
+    for (auto i(0); i < 1000; ++i) {
+        // More than the number of requests in flight.
+        paths.emplace_back(join({tmpdir.name(), std::to_string(i)}));
+        fstream(paths.back(), fstream::out) << string(i, 'x');
+    }
+    paths.emplace_back(join({tmpdir.name(), "missing"}));
+    paths.emplace_back(join({tmpdir.name(), "0", "file"}));
+    paths.emplace_back(tmpdir.name());
+    paths.emplace_back(join({tmpdir.name(), "link"}));
+    symlink("1", paths.back().c_str());
+    for (const auto disable: {false, true}) {
+        if (disable) {
+            setenv("PYPP_DISABLE_IO_URING", "1", 1);
+        }
+        for (const auto follow: {true, false}) {
+            const auto results(stat_many(paths, follow, 2));
+            ASSERT_EQ(results.size(), paths.size());
+            for (size_t i(0); i < 1000; ++i) {
+                ASSERT_EQ(results[i].error, 0);
+                ASSERT_EQ(results[i].status.st_size, i);
+                const auto expected(stat(paths[i]));
+                ASSERT_EQ(results[i].status.st_ino, expected.st_ino);
+                ASSERT_EQ(results[i].status.st_dev, expected.st_dev);
+                ASSERT_EQ(results[i].status.st_mtime_ns, expected.st_mtime_ns);
+            }
+            ASSERT_EQ(results[1000].error, ENOENT);
+            ASSERT_EQ(results[1001].error, ENOTDIR);
+            ASSERT_TRUE(S_ISDIR(results[1002].status.st_mode));
+            ASSERT_EQ(S_ISLNK(results[1003].status.st_mode), not follow);
+        }
+        unsetenv("PYPP_DISABLE_IO_URING");
+    }
+    const auto results(stat_many(paths.begin() + 1000, paths.end()));
+    ASSERT_EQ(results.size(), 4);
+    ASSERT_EQ(results[0].error, ENOENT);
+    ASSERT_TRUE(stat_many(vector<string>()).empty());
 }
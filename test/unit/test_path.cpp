@@ -4,13 +4,20 @@
  * Link all test files with the `gtest_main` library to create a command line
  * test runner.
  */
+#include <fcntl.h>  // open
+#include <sys/stat.h>  // mkfifo
+#include <unistd.h>  // close
+#include <cstdint>
 #include <cstdio>
+#include <deque>
 #include <fstream>
 #include <iterator>
 #include <set>
 #include <string>
 #include <stdexcept>
+#include <thread>
 #include <typeinfo>
+#include <unordered_set>
 #include <vector>
 #include <gtest/gtest.h>
 #include "pypp/pypp.hpp"
@@ -36,6 +43,70 @@ using testing::Test;
 using testing::Types;
 
 
+namespace {
+
+/**
+ * Reference implementation of normpath() for differential testing.
+ *
+ * This is the original implementation based on splitting and joining
+ * strings, including its handling of parent references.
+ *
+ * @param path: input path
+ * @param sep: path separator
+ * @return: normalized path
+ */
+string reference_normpath(const string& path, char sep) {
+    ssize_t level{0};
+    std::deque<string> parts;
+    for (const auto& item: str::split(path, string(1, sep))) {
+        if (item.empty() or item == ".") {
+            continue;
+        }
+        if (item == "..") {
+            --level;
+            if (level >= 0) {
+                parts.pop_back();
+            }
+            else if (not isabs(path)) {
+                parts.push_back(item);
+            }
+        }
+        else {
+            ++level;
+            parts.push_back(item);
+        }
+    }
+    string normed(str::join(vector<string>(parts.begin(), parts.end()), string(1, sep)));
+    if (str::startswith(path, sep)) {
+        normed.insert(0, 1, sep);
+    }
+    else if (normed.empty()) {
+        normed = ".";
+    }
+    return normed;
+}
+
+
+/**
+ * Generate a random path from a small alphabet.
+ *
+ * @param seed: random state
+ * @return: random path
+ */
+string random_path(std::uint64_t& seed) {
+    static const char alphabet[]{'/', '/', '\\', '.', '.', 'a'};
+    seed = seed * 6364136223846793005 + 1442695040888963407;
+    string path;
+    for (auto size(seed >> 60); size > 0; --size) {
+        seed = seed * 6364136223846793005 + 1442695040888963407;
+        path += alphabet[(seed >> 33) % sizeof(alphabet)];
+    }
+    return path;
+}
+
+}  // internal linkage
+
+
 /**
  * Test the join() function.
  */
@@ -112,6 +183,18 @@ TEST(path, normpath) {
 }
 
 
+/**
+ * Test the normpath() function against the reference implementation.
+ */
+TEST(path, normpath_random) {
+    std::uint64_t seed(12345);
+    for (auto i(0); i < 100000; ++i) {
+        const auto path(random_path(seed));
+        ASSERT_EQ(normpath(path), reference_normpath(path, '/')) << path;
+    }
+}
+
+
 /**
  * Test the abspath() function.
  */
@@ -226,6 +309,27 @@ TYPED_TEST(PurePathTest, copy) {
 }
 
 
+/**
+ * Test path normalization against the reference implementation.
+ */
+TYPED_TEST(PurePathTest, normalize_random) {
+    const auto sep(TypeParam::sep);
+    std::uint64_t seed(12345);
+    for (auto i(0); i < 100000; ++i) {
+        const auto path(random_path(seed));
+        string expected;
+        if (str::startswith(path, sep)) {
+            expected = reference_normpath(path.substr(1), sep);
+            expected = expected == "." ? string(1, sep) : sep + expected;
+        }
+        else {
+            expected = reference_normpath(path, sep);
+        }
+        ASSERT_EQ(string(TypeParam(path)), expected) << path;
+    }
+}
+
+
 /**
  * Test the PurePath equality operator.
  */
@@ -267,6 +371,28 @@ TYPED_TEST(PurePathTest, lt_op) {
 }
 
 
+/**
+ * Test the PurePath hash() function.
+ */
+TYPED_TEST(PurePathTest, hash) {
+    TypeParam path(this->sep("abc/xyz"));
+    const auto hash(path.hash());
+    ASSERT_EQ(hash, TypeParam(this->sep("./abc//xyz/")).hash());
+    ASSERT_EQ(hash, std::hash<TypeParam>()(path));
+    ASSERT_EQ(TypeParam(path).hash(), hash);  // copied cache
+    path = path.parent();
+    ASSERT_EQ(path.hash(), TypeParam("abc").hash());
+    ASSERT_NE(path.hash(), hash);
+    ASSERT_NE(path, TypeParam(this->sep("abc/xyz")));
+    std::unordered_set<TypeParam> paths;
+    for (const auto str: {"abc", "abc/", "./abc", "xyz", "abc/xyz"}) {
+        paths.emplace(this->sep(str));
+    }
+    ASSERT_EQ(paths.size(), 3u);
+    ASSERT_EQ(paths.count(TypeParam("xyz")), 1u);
+}
+
+
 /**
  * Test the PurePath std::string operator.
  */
@@ -385,6 +511,31 @@ TYPED_TEST(PurePathTest, joinpath) {
 }
 
 
+/**
+ * Test the PurePath joinpath() method against joining strings.
+ */
+TYPED_TEST(PurePathTest, joinpath_random) {
+    const auto sep(TypeParam::sep);
+    std::uint64_t seed(12345);
+    for (auto i(0); i < 100000; ++i) {
+        auto path(TypeParam(random_path(seed)));
+        const auto other(random_path(seed));
+        string joined(other);
+        if (not str::startswith(other, sep)) {
+            joined = string(path);
+            if (not str::endswith(joined, sep)) {
+                joined += sep;
+            }
+            joined += other;
+        }
+        const TypeParam expected(joined);
+        ASSERT_EQ(string(path.joinpath(other)), string(expected)) << string(path) << " " << other;
+        path /= other;
+        ASSERT_EQ(string(path), string(expected)) << other;
+    }
+}
+
+
 /**
  * Test the PurePath join operator.
  */
@@ -432,6 +583,39 @@ TYPED_TEST(PurePathTest, parents) {
 }
 
 
+/**
+ * Test the PurePath ancestors() method.
+ */
+TYPED_TEST(PurePathTest, ancestors) {
+    const TypeParam path(this->sep("/abc/def/ghi"));
+    vector<string> ancestors;
+    for (const auto ancestor: path.ancestors()) {
+        ancestors.emplace_back(ancestor);
+    }
+    ASSERT_EQ(ancestors, vector<string>({this->sep("/abc/def"), this->sep("/abc"), this->sep("/")}));
+    ASSERT_TRUE(TypeParam().ancestors().begin() == TypeParam().ancestors().end());
+}
+
+
+/**
+ * Test the Ancestors generator for unnormalized paths.
+ */
+TEST(path, Ancestors) {
+    vector<string> ancestors;
+    for (const auto ancestor: Ancestors("abc//def/./ghi//", '/')) {
+        ancestors.emplace_back(ancestor);
+    }
+    ASSERT_EQ(ancestors, vector<string>({"abc//def/.", "abc//def", "abc", "."}));
+    ancestors.clear();
+    for (const auto ancestor: Ancestors("//abc", '/')) {
+        ancestors.emplace_back(ancestor);
+    }
+    ASSERT_EQ(ancestors, vector<string>({"//"}));
+    ASSERT_FALSE(Ancestors("", '/').active());
+    ASSERT_FALSE(Ancestors("///", '/').active());
+}
+
+
 /**
  * Test the PurePath::relative_to() method.
  */
@@ -456,6 +640,8 @@ TYPED_TEST(PurePathTest, with_name) {
     ASSERT_THROW(TypeParam("abc").with_name(""), invalid_argument);
     ASSERT_THROW(TypeParam("abc").with_name("."), invalid_argument);
     ASSERT_THROW(TypeParam("abc").with_name(this->sep("def/")), invalid_argument);
+    ASSERT_THROW(TypeParam("abc").with_name(this->sep("/def")), invalid_argument);
+    ASSERT_THROW(TypeParam("abc").with_name(".def"), invalid_argument);
     ASSERT_EQ(TypeParam("xyz"), TypeParam("abc").with_name("xyz"));
     ASSERT_EQ(TypeParam(this->sep("/xyz")), TypeParam(this->sep("/abc")).with_name("xyz"));
     ASSERT_EQ(TypeParam(this->sep("abc/xyz")), TypeParam(this->sep("abc/def")).with_name("xyz"));
@@ -475,6 +661,23 @@ TYPED_TEST(PurePathTest, with_suffix) {
     ASSERT_EQ(TypeParam("abc.xyz"), TypeParam("abc").with_suffix(".xyz"));
     ASSERT_EQ(TypeParam("abc..xyz"), TypeParam("abc.").with_suffix(".xyz"));
     ASSERT_EQ(TypeParam("abc.xyz"), TypeParam("abc.def").with_suffix(".xyz"));
+    ASSERT_EQ(TypeParam(this->sep("a.b/abc.xyz")), TypeParam(this->sep("a.b/abc")).with_suffix(".xyz"));
+    ASSERT_EQ(TypeParam("abc.def"), TypeParam("abc.def.ghi").with_suffix(""));
+    ASSERT_THROW(TypeParam(".abc").with_suffix(".xyz"), invalid_argument);
+}
+
+
+/**
+ * Test the with_suffix() function for a sequence of paths.
+ */
+TYPED_TEST(PurePathTest, with_suffix_range) {
+    const vector<TypeParam> paths{TypeParam("abc"), TypeParam(this->sep("abc/def.txt"))};
+    const vector<TypeParam> expected{TypeParam("abc.xyz"), TypeParam(this->sep("abc/def.xyz"))};
+    ASSERT_EQ(with_suffix(paths, ".xyz"), expected);
+    vector<TypeParam> result;
+    with_suffix(paths.begin(), paths.end(), ".xyz", std::back_inserter(result));
+    ASSERT_EQ(result, expected);
+    ASSERT_THROW(with_suffix(paths, "xyz"), invalid_argument);
 }
 
 
@@ -508,6 +711,16 @@ TEST_F(PathTest, pure) {
 }
 
 
+/**
+ * Test the Path::hash() method.
+ */
+TEST_F(PathTest, hash) {
+    ASSERT_EQ(Path("abc/xyz").hash(), PurePath("abc/xyz").hash());
+    std::unordered_set<Path> paths{Path("abc"), Path("./abc"), Path("xyz")};
+    ASSERT_EQ(paths.size(), 2u);
+}
+
+
 /**
  * Test the Path::exists() method.
  */
@@ -558,6 +771,53 @@ TEST_F(PathTest, is_symlink) {
 }
 
 
+/**
+ * Test the Path::stat() and Path::lstat() methods.
+ */
+TEST_F(PathTest, stat) {
+    const auto file(Path(tmpdir.name()) / "stat_test");
+    file.write_bytes("abc");
+    const auto link(Path(tmpdir.name()) / "stat_link");
+    link.symlink_to("stat_test");
+    const auto status(file.stat());
+    ASSERT_EQ(status.st_size, 3);
+    ASSERT_TRUE(isfile(status) and not isdir(status) and not islink(status));
+    ASSERT_GT(status.st_mtime_ns, 0);
+    ASSERT_EQ(link.stat().st_ino, status.st_ino);
+    ASSERT_TRUE(islink(link.lstat()));
+    ASSERT_TRUE(islink(link.stat(false)));
+    ASSERT_TRUE(isdir(Path(tmpdir.name()).stat()));
+    ASSERT_THROW((file / "missing").stat(), runtime_error);
+}
+
+
+/**
+ * Test the Path::info() method.
+ */
+TEST_F(PathTest, info) {
+    const auto file(Path(tmpdir.name()) / "info_test");
+    file.write_bytes("abc");
+    const auto info(file.info());
+    ASSERT_TRUE(info.exists() and info.is_file() and not info.is_dir() and not info.is_symlink());
+    ASSERT_EQ(info.stat().st_size, 3);
+    file.unlink();
+    ASSERT_TRUE(info.exists());  // cached
+    ASSERT_FALSE(file.info().exists());
+    ASSERT_THROW(file.info().stat(), runtime_error);
+    const auto link(Path(tmpdir.name()) / "info_link");
+    link.symlink_to(tmpdir.name());
+    const auto link_info(link.info());
+    ASSERT_TRUE(link_info.is_symlink() and link_info.is_dir() and not link_info.is_dir(false));
+    ASSERT_NE(link_info.stat().st_ino, link_info.stat(false).st_ino);
+    const auto broken(Path(tmpdir.name()) / "info_broken");
+    broken.symlink_to("missing");
+    const auto broken_info(broken.info());
+    ASSERT_TRUE(broken_info.is_symlink() and broken_info.exists(false));
+    ASSERT_FALSE(broken_info.exists());
+    ASSERT_THROW(broken_info.stat(), runtime_error);
+}
+
+
 /**
  * Test the Path::open() method.
  */
@@ -641,6 +901,58 @@ TEST_F(PathTest, read_bytes) {
 }
 
 
+/**
+ * Test the Path::read_bytes() method for files that are not read in one call.
+ */
+TEST_F(PathTest, read_bytes_special) {
+    string data;
+    for (auto i(0); i < 200000; ++i) {
+        data += static_cast<char>(i * 7 % 256);
+    }
+    const auto path(Path(tmpdir.name()) / "read_bytes_fifo");
+    ASSERT_EQ(mkfifo(string(path).c_str(), 0600), 0);
+    std::thread writer([&path, &data]() {
+        path.write_bytes(data);
+    });
+    const auto result(path.read_bytes());  // size is unknown
+    writer.join();
+    ASSERT_EQ(data, result);
+    const Path proc("/proc/self/status");
+    if (proc.exists()) {
+        // Linux procfs files report a size of zero.
+        ASSERT_TRUE(str::startswith(proc.read_text(), "Name:"));
+    }
+    ASSERT_THROW((path / "missing").read_bytes(), runtime_error);
+}
+
+
+/**
+ * Test the MappedFile class.
+ */
+TEST_F(PathTest, MappedFile) {
+    string data;
+    for (auto i(0); i < 100000; ++i) {
+        data += static_cast<char>(i % 256);
+    }
+    const auto path(Path(tmpdir.name()) / "mapped");
+    const string name(path);
+    path.write_bytes(data);
+    MappedFile mapped(name, MADV_RANDOM);
+    ASSERT_EQ(mapped.size(), data.size());
+    ASSERT_EQ(string(mapped.view()), data);
+    mapped.advise(MADV_WILLNEED);
+    const MappedFile moved(std::move(mapped));
+    ASSERT_EQ(moved.data()[1], 1);
+    ASSERT_EQ(mapped.data(), nullptr);
+    path.write_bytes("");
+    const MappedFile empty(name);
+    ASSERT_EQ(empty.size(), 0);
+    ASSERT_EQ(empty.view(), "");
+    ASSERT_THROW(MappedFile(tmpdir.name()), runtime_error);  // not a file
+    ASSERT_THROW(MappedFile(string(path / "missing")), runtime_error);
+}
+
+
 /**
  * Test the Path::read_text() method.
  */
@@ -652,6 +964,60 @@ TEST_F(PathTest, read_text) {
 }
 
 
+/**
+ * Test the Path::lines() method.
+ */
+TEST_F(PathTest, lines) {
+    const auto path(Path(tmpdir.name()) / "lines_test");
+    path.write_bytes("abc\nxyz\r\n\r123");
+    vector<string> lines;
+    for (const auto line: path.lines()) {
+        lines.emplace_back(line);
+    }
+    ASSERT_EQ(vector<string>({"abc", "xyz", "", "123"}), lines);
+    lines.clear();
+    for (const auto line: path.lines(true)) {
+        lines.emplace_back(line);
+    }
+    ASSERT_EQ(vector<string>({"abc\n", "xyz\r\n", "\r", "123"}), lines);
+    const auto next_fd = []() {
+        const auto fd(open("/dev/null", O_RDONLY));
+        close(fd);
+        return fd;
+    };
+    const auto fd(next_fd());
+    ASSERT_THROW(path.parent().lines(), runtime_error);  // not a file
+    ASSERT_EQ(fd, next_fd());  // not leaked
+    ASSERT_THROW((path / "missing").lines(), runtime_error);
+}
+
+
+/**
+ * Test the Path::lines() method for lines that cross buffer boundaries.
+ */
+TEST_F(PathTest, lines_long) {
+    const auto path(Path(tmpdir.name()) / "lines_long_test");
+    vector<string> expected;
+    string data;
+    for (auto i(0); i < 50; ++i) {
+        // Include a line that is longer than the buffer.
+        expected.emplace_back(string(i == 25 ? 100000 : 5000 + i, 'a' + i % 26));
+        data += expected.back() + (i % 2 ? "\r\n" : "\n");
+    }
+    path.write_bytes(data);
+    vector<string> lines;
+    for (const auto line: path.lines()) {
+        lines.emplace_back(line);
+    }
+    ASSERT_EQ(expected, lines);
+    lines.clear();
+    for (const auto line: path.lines(false, 16)) {
+        lines.emplace_back(line);
+    }
+    ASSERT_EQ(expected, lines);
+}
+
+
 /**
  * Test the Path::write_bytes() method.
  */
@@ -678,6 +1044,40 @@ TEST_F(PathTest, write_text) {
 }
 
 
+/**
+ * Test the Path::writer() method.
+ */
+TEST_F(PathTest, writer) {
+    const auto path(Path(tmpdir.name()) / "writer_test");
+    auto writer(path.writer(false, 8));
+    writer.write("abc");
+    writer.write("def");
+    ASSERT_EQ(path.read_bytes(), "");  // buffered
+    writer.write("ghi");  // overflow
+    ASSERT_EQ(path.read_bytes(), "abcdefghi");
+    writer.write("jk");
+    writer.flush();
+    ASSERT_EQ(path.read_bytes(), "abcdefghijk");
+    const string large(100000, 'x');
+    const vector<string> records({"1", large, "2"});
+    writer.writelines(records.begin(), records.end());
+    auto moved(std::move(writer));
+    ASSERT_THROW(writer.write("abc"), runtime_error);
+    moved.close();
+    moved.close();  // no op
+    ASSERT_EQ(path.read_bytes(), "abcdefghijk1" + large + "2");
+    ASSERT_THROW(moved.write("abc"), runtime_error);
+    {
+        auto append(path.writer(true));
+        append.write("3");
+    }  // written on destruction
+    ASSERT_EQ(path.read_bytes(), "abcdefghijk1" + large + "23");
+    path.writer().close();  // truncate
+    ASSERT_EQ(path.read_bytes(), "");
+    ASSERT_THROW((path / "missing").writer(), runtime_error);
+}
+
+
 /**
  * Test the Path::iterdir() method.
  */
@@ -693,3 +1093,55 @@ TEST_F(PathTest, iterdir) {
     ASSERT_EQ(set<Path>({dir, file}), items);
     ASSERT_THROW(file.iterdir(), runtime_error);  // not a directory
 }
+
+
+/**
+ * Test the Path::scandir() method.
+ */
+TEST_F(PathTest, scandir) {
+    const TemporaryDirectory tmpdir;
+    const Path root(tmpdir.name());
+    (root / "file").open("wt");
+    (root / "dir").mkdir();
+    set<string> dirs;
+    for (const auto& entry: root.scandir()) {
+        if (entry.is_dir()) {
+            dirs.insert(entry.name());
+        }
+    }
+    ASSERT_EQ(set<string>({"dir"}), dirs);
+}
+
+
+/**
+ * Test the Path::glob() method.
+ */
+TEST_F(PathTest, glob) {
+    const Path root(tmpdir.name());
+    (root / "dir" / "sub").mkdir(0777, true);
+    for (const auto name: {"a.txt", "b.dat", "dir/c.txt", "dir/sub/d.txt"}) {
+        (root / name).open("wt");
+    }
+    ASSERT_EQ(vector<Path>({root / "a.txt"}), root.glob("*.txt"));
+    ASSERT_EQ(vector<Path>({root / "dir" / "c.txt"}), root.glob("*/*.txt"));
+    const auto dir(root / "dir");
+    ASSERT_EQ(vector<Path>({dir / "c.txt", dir / "sub", dir / "sub" / "d.txt"}), dir.glob("**/*"));
+    ASSERT_TRUE(root.glob("*.csv").empty());
+    ASSERT_THROW(root.glob(""), invalid_argument);
+    ASSERT_THROW(root.glob("/*"), invalid_argument);
+}
+
+
+/**
+ * Test the Path::rglob() method.
+ */
+TEST_F(PathTest, rglob) {
+    const Path root(tmpdir.name());
+    (root / "dir" / "sub").mkdir(0777, true);
+    for (const auto name: {"a.txt", "b.dat", "dir/c.txt", "dir/sub/d.txt"}) {
+        (root / name).open("wt");
+    }
+    const vector<Path> txt({root / "a.txt", root / "dir" / "c.txt", root / "dir" / "sub" / "d.txt"});
+    ASSERT_EQ(txt, root.rglob("*.txt"));
+    ASSERT_EQ(vector<Path>({root / "dir" / "sub"}), root.rglob("sub"));
+}
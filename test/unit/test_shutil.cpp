@@ -0,0 +1,99 @@
+/// Test suite for the POSIX shutil module.
+///
+/// Link all test files with the `gtest_main` library to create a command line
+/// test runner.
+///
+#include <unistd.h>  // symlink
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <gtest/gtest.h>
+#include "pypp/pypp.hpp"
+
+
+using pypp::os::makedirs;
+using pypp::path::exists;
+using pypp::path::isdir;
+using pypp::path::isfile;
+using pypp::path::join;
+using pypp::tempfile::TemporaryDirectory;
+using std::fstream;
+using std::runtime_error;
+using std::string;
+using testing::TestWithParam;
+using testing::Values;
+
+using namespace pypp::shutil;
+
+
+/// Test fixture for the rmtree() function.
+///
+/// The test parameter is the number of threads.
+///
+class RmtreeTest: public TestWithParam<size_t>
+{
+protected:
+    /// Create a directory tree.
+    ///
+    /// This includes a symbolic link to a directory outside of the tree.
+    ///
+    /// @return: tree root
+    string tree() const {
+        const auto root(join({tmpdir.name(), "root"}));
+        for (const auto dir: {"a", "b"}) {
+            makedirs(join({root, dir, "c"}));
+            for (auto i(0); i < 100; ++i) {
+                fstream(join({root, dir, "c", std::to_string(i)}), fstream::out);
+            }
+            fstream(join({root, dir, "file"}), fstream::out);
+        }
+        makedirs(join({tmpdir.name(), "target"}));
+        fstream(join({tmpdir.name(), "target", "file"}), fstream::out);
+        symlink("../target", join({root, "link"}).c_str());
+        return root;
+    }
+
+    const TemporaryDirectory tmpdir;
+};
+
+
+/// Test the rmtree() function.
+///
+TEST_P(RmtreeTest, rmtree)
+{
+    const auto root(tree());
+    rmtree(root, false, GetParam());
+    ASSERT_FALSE(exists(root));
+    ASSERT_TRUE(isfile(join({tmpdir.name(), "target", "file"})));  // not followed
+}
+
+
+/// Test the rmtree() function for errors.
+///
+TEST_P(RmtreeTest, rmtree_errors)
+{
+    const auto root(tree());
+    const auto missing(join({tmpdir.name(), "missing"}));
+    ASSERT_THROW(rmtree(missing, false, GetParam()), runtime_error);
+    rmtree(missing, true, GetParam());
+    const auto link(join({root, "link"}));
+    ASSERT_THROW(rmtree(link, false, GetParam()), runtime_error);
+    rmtree(link, true, GetParam());
+    ASSERT_TRUE(isdir(link));
+    const auto file(join({root, "a", "file"}));
+    ASSERT_THROW(rmtree(file, false, GetParam()), runtime_error);
+    ASSERT_TRUE(isfile(file));
+    if (geteuid() != 0) {
+        // Permissions are not enforced for root.
+        const auto locked(join({root, "a"}));
+        chmod(locked.c_str(), 0500);
+        ASSERT_THROW(rmtree(root, false, GetParam()), runtime_error);
+        rmtree(root, true, GetParam());
+        ASSERT_TRUE(isfile(file));
+        ASSERT_FALSE(exists(join({root, "b"})));
+        chmod(locked.c_str(), 0700);
+    }
+}
+
+
+INSTANTIATE_TEST_CASE_P(shutil, RmtreeTest, Values(1, 4));
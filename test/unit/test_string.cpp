@@ -3,6 +3,7 @@
 /// Link all test files with the `gtest_main` library to create a command-line 
 /// test runner.
 ///
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -19,6 +20,25 @@ using std::vector;
 using namespace pypp::str;
 
 
+namespace {
+
+/// Collect the items from a generator.
+///
+/// @param items generator
+/// @return items as strings
+template <typename Generator>
+vector<string> collect(Generator&& items)
+{
+    vector<string> result;
+    for (const auto item: items) {
+        result.emplace_back(item);
+    }
+    return result;
+}
+
+}  // internal linkage
+
+
 /// Test the whitespace constant.
 ///
 TEST(string, whitespace)
@@ -45,6 +65,50 @@ TEST(string, lower_str)
 }
 
 
+/// Test the lower() function for non-letters and long strings.
+///
+/// Long strings exercise the vectorized implementation, including the
+/// boundaries of the ASCII letter range and non-ASCII bytes.
+///
+TEST(string, lower_str_long)
+{
+    string str;
+    for (auto i(0); i < 256; ++i) {
+        str += static_cast<char>(i);
+    }
+    const auto lowered(lower(str));
+    ASSERT_EQ(lowered.size(), str.size());
+    for (auto i(0); i < 256; ++i) {
+        const auto c(static_cast<char>(i));
+        const auto expected(i >= 'A' and i <= 'Z' ? static_cast<char>(i + 32) : c);
+        ASSERT_EQ(lowered[i], expected);
+        ASSERT_EQ(lower(c), expected);
+    }
+}
+
+
+/// Test the in-place lower() function.
+///
+TEST(string, lower_inplace)
+{
+    string str("@ABC[`xyz{XYZ 0123456789 ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+    lower(&str[0], &str[0] + str.size());
+    ASSERT_EQ(str, "@abc[`xyz{xyz 0123456789 abcdefghijklmnopqrstuvwxyz");
+}
+
+
+/// Test the lower() function with an output buffer.
+///
+TEST(string, lower_buffer)
+{
+    static const string str("@ABC[`xyz{XYZ 0123456789 ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+    string buffer(str.size() + 1, '!');
+    const auto end(lower(str.data(), str.data() + str.size(), &buffer[0]));
+    ASSERT_EQ(end, &buffer[0] + str.size());
+    ASSERT_EQ(buffer, "@abc[`xyz{xyz 0123456789 abcdefghijklmnopqrstuvwxyz!");
+}
+
+
 /// Test the upper() function for a char.
 ///
 TEST(string, upper_char)
@@ -62,6 +126,47 @@ TEST(string, upper_str)
 }
 
 
+/// Test the upper() function for non-letters and long strings.
+///
+TEST(string, upper_str_long)
+{
+    string str;
+    for (auto i(0); i < 256; ++i) {
+        str += static_cast<char>(i);
+    }
+    const auto uppered(upper(str));
+    ASSERT_EQ(uppered.size(), str.size());
+    for (auto i(0); i < 256; ++i) {
+        const auto c(static_cast<char>(i));
+        const auto expected(i >= 'a' and i <= 'z' ? static_cast<char>(i - 32) : c);
+        ASSERT_EQ(uppered[i], expected);
+        ASSERT_EQ(upper(c), expected);
+    }
+}
+
+
+/// Test the in-place upper() function.
+///
+TEST(string, upper_inplace)
+{
+    string str("@abc[`XYZ{xyz 0123456789 abcdefghijklmnopqrstuvwxyz");
+    upper(&str[0], &str[0] + str.size());
+    ASSERT_EQ(str, "@ABC[`XYZ{XYZ 0123456789 ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+}
+
+
+/// Test the upper() function with an output buffer.
+///
+TEST(string, upper_buffer)
+{
+    static const string str("@abc[`XYZ{xyz 0123456789 abcdefghijklmnopqrstuvwxyz");
+    string buffer(str.size(), ' ');
+    const auto end(upper(str.data(), str.data() + str.size(), &buffer[0]));
+    ASSERT_EQ(end, &buffer[0] + str.size());
+    ASSERT_EQ(buffer, "@ABC[`XYZ{XYZ 0123456789 ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+}
+
+
 /// Test the lstrip() function for whitespace.
 ///
 TEST(string, lstrip)
@@ -137,6 +242,59 @@ TEST(string, strip_chars)
 }
 
 
+/// Test the strip functions for a temporary string.
+///
+TEST(string, strip_rvalue)
+{
+    // Use a string that is too long for the small string optimization so that
+    // reuse of its buffer can be verified.
+    const string body(100, 'x');
+    auto str(whitespace + body + whitespace);
+    const auto data(str.data());
+    const auto stripped(strip(std::move(str)));
+    ASSERT_EQ(stripped, body);
+    ASSERT_EQ(stripped.data(), data);
+    ASSERT_EQ(lstrip(whitespace + body + whitespace), body + whitespace);
+    ASSERT_EQ(rstrip(whitespace + body + whitespace), whitespace + body);
+    ASSERT_EQ(strip(string("001122abc001122"), string("012")), "abc");
+    ASSERT_EQ(strip(string(whitespace)), "");
+}
+
+/// Test the CharSet class.
+///
+TEST(string, CharSet)
+{
+    static constexpr CharSet chars("a\x7f\x80\xff");
+    static_assert(chars.contains('a'), "constant expression");
+    static_assert(not chars.contains('b'), "constant expression");
+    ASSERT_TRUE(chars.contains('\x80'));
+    ASSERT_TRUE(chars.contains('\xff'));
+    ASSERT_FALSE(chars.contains('\0'));
+    ASSERT_FALSE(CharSet().contains('a'));
+    const CharSet nul(string("a\0", 2));
+    ASSERT_TRUE(nul.contains('\0'));
+    for (const auto c: whitespace) {
+        ASSERT_TRUE(whitespace_set.contains(c));
+    }
+    ASSERT_FALSE(whitespace_set.contains('a'));
+}
+
+
+/// Test the strip functions for a CharSet and long runs of set members.
+///
+TEST(string, strip_charset)
+{
+    static constexpr CharSet chars("0\xa0");
+    const string pad(string(70, '0') + "\xa0\xa0" + string(30, '0'));
+    const string body("a\xa0" "1" + string(40, 'x') + "z\xa0" "0b");
+    ASSERT_EQ(lstrip(pad + body + pad, chars), body + pad);
+    ASSERT_EQ(rstrip(pad + body + pad, chars), pad + body);
+    ASSERT_EQ(strip(pad + body + pad, chars), body);
+    ASSERT_EQ(strip(pad + pad, chars), "");
+    ASSERT_EQ(strip(string(100, ' ') + body + "\n"), body);
+}
+
+
 /**
  * Test the join() function for a string separator.
  *
@@ -159,6 +317,65 @@ TEST(string, join_char) {
 }
 
 
+/// Test the join() function for iterators.
+///
+TEST(string, join_iter)
+{
+    static const vector<string> items({"a", "b", "c"});
+    static const char* const chars[] = {"a", "b", "c"};
+    ASSERT_EQ(join(items.begin(), items.end(), ", "), "a, b, c");
+    ASSERT_EQ(join(items.begin(), items.end()), "abc");
+    ASSERT_EQ(join(std::begin(chars), std::end(chars), "-"), "a-b-c");
+    ASSERT_EQ(join(items.begin(), items.begin(), ", "), "");
+    ASSERT_EQ(join(vector<string>(), ", "), "");
+}
+
+
+/// Test the join() function for a generator.
+///
+TEST(string, join_generator)
+{
+    auto items(isplit("a b c"));
+    ASSERT_EQ(join(items.begin(), items.end(), ","), "a,b,c");
+}
+
+
+/// Test the join() function with a string as output.
+///
+TEST(string, join_string)
+{
+    static const vector<string> items({"a", "b", "c"});
+    string out("xyz:");
+    ASSERT_EQ(&join(out, items.begin(), items.end(), ","), &out);
+    ASSERT_EQ(out, "xyz:a,b,c");
+}
+
+
+/// Test the join() function with a stream as output.
+///
+TEST(string, join_stream)
+{
+    static const vector<string> items({"a", "b", "c"});
+    std::ostringstream out;
+    join(out, items.begin(), items.end(), ", ");
+    ASSERT_EQ(out.str(), "a, b, c");
+}
+
+
+/// Test the join() function with a buffer as output.
+///
+TEST(string, join_buffer)
+{
+    static const vector<string> items({"a", "b", "c"});
+    char buffer[8];
+    const auto last(join(buffer, buffer + sizeof(buffer), items.begin(), items.end(), ", "));
+    ASSERT_EQ(string(buffer, last), "a, b, c");
+    ASSERT_THROW(join(buffer, buffer + 6, items.begin(), items.end(), ", "), std::length_error);
+    auto generator(isplit("a b c"));
+    ASSERT_THROW(join(buffer, buffer + 4, generator.begin(), generator.end(), ","), std::length_error);
+}
+
+
 /// Test the split() function for whitespace.
 ///
 TEST(string, split)
@@ -217,6 +434,198 @@ TEST(string, rsplit_sep)
 }
 
 
+/// Test the StringView class.
+///
+TEST(string, StringView)
+{
+    static const string str("abcdef");
+    const StringView view(str);
+    ASSERT_EQ(view.data(), str.data());
+    ASSERT_EQ(view.size(), str.size());
+    ASSERT_FALSE(view.empty());
+    ASSERT_TRUE(StringView().empty());
+    ASSERT_EQ(string(view), str);
+    ASSERT_EQ(view.substr(2, 3), "cde");
+    ASSERT_EQ(view.substr(2), "cdef");
+    ASSERT_EQ(view.substr(6), "");
+    ASSERT_THROW(view.substr(7), std::out_of_range);
+    ASSERT_EQ(view, StringView("abcdef"));
+    ASSERT_NE(view, StringView("abcde"));
+    ASSERT_TRUE(StringView("abc") < StringView("abd"));
+    ASSERT_TRUE(StringView("abc") < StringView("abcd"));
+    ASSERT_FALSE(StringView("abc") < StringView("abc"));
+}
+
+
+/// Test the isplit() function for whitespace.
+///
+TEST(string, isplit)
+{
+    static const string str(" \rabc\t xyz \n123 \n");
+    ASSERT_EQ(collect(isplit(str)), vector<string>({"abc", "xyz", "123"}));
+    ASSERT_EQ(collect(isplit(str, 0)), vector<string>({"abc\t xyz \n123 \n"}));
+    ASSERT_EQ(collect(isplit(str, 1)), vector<string>({"abc", "xyz \n123 \n"}));
+    ASSERT_EQ(collect(isplit("abc")), vector<string>({"abc"}));
+    ASSERT_EQ(collect(isplit(" \n")), vector<string>());
+    ASSERT_EQ(collect(isplit("")), vector<string>());
+    for (const auto item: isplit(str)) {
+        // Items are views into the original string.
+        ASSERT_GE(item.data(), str.data());
+        ASSERT_LE(item.data() + item.size(), str.data() + str.size());
+    }
+}
+
+
+/// Test the isplit() function for a separator.
+///
+TEST(string, isplit_sep)
+{
+    static const string str(", abc, , xyz, ");
+    static const string sep(", ");
+    ASSERT_EQ(collect(isplit(str, sep)), vector<string>({"", "abc", "", "xyz", ""}));
+    ASSERT_EQ(collect(isplit(str, sep, 0)), vector<string>{str});
+    ASSERT_EQ(collect(isplit(str, sep, 2)), vector<string>({"", "abc", ", xyz, "}));
+    ASSERT_EQ(collect(isplit(sep, sep)), vector<string>({"", ""}));
+    ASSERT_EQ(collect(isplit("", sep)), vector<string>({""}));
+    ASSERT_THROW(isplit(str, ""), invalid_argument);
+}
+
+
+/// Test the irsplit() function for whitespace.
+///
+TEST(string, irsplit)
+{
+    static const string str(" \rabc\t xyz \n123 \n");
+    ASSERT_EQ(collect(irsplit(str)), vector<string>({"123", "xyz", "abc"}));
+    ASSERT_EQ(collect(irsplit(str, 0)), vector<string>({" \rabc\t xyz \n123"}));
+    ASSERT_EQ(collect(irsplit(str, 1)), vector<string>({"123", " \rabc\t xyz"}));
+    ASSERT_EQ(collect(irsplit("abc")), vector<string>({"abc"}));
+    ASSERT_EQ(collect(irsplit(" \n")), vector<string>());
+    ASSERT_EQ(collect(irsplit("")), vector<string>());
+}
+
+
+/// Test the irsplit() function for a separator.
+///
+TEST(string, irsplit_sep)
+{
+    static const string str(", abc, , xyz, ");
+    static const string sep(", ");
+    ASSERT_EQ(collect(irsplit(str, sep)), vector<string>({"", "xyz", "", "abc", ""}));
+    ASSERT_EQ(collect(irsplit(str, sep, 0)), vector<string>{str});
+    ASSERT_EQ(collect(irsplit(str, sep, 2)), vector<string>({"", "xyz", ", abc, "}));
+    ASSERT_EQ(collect(irsplit(sep, sep)), vector<string>({"", ""}));
+    ASSERT_EQ(collect(irsplit("", sep)), vector<string>({""}));
+    ASSERT_EQ(collect(irsplit("a,,b", ",")), vector<string>({"b", "", "a"}));
+    ASSERT_THROW(irsplit(str, ""), invalid_argument);
+}
+
+
+/// Test the rsplit() function for a record with many fields.
+///
+TEST(string, rsplit_fields)
+{
+    string str;
+    for (auto i(0); i < 1000; ++i) {
+        str += std::to_string(i) + ", ";
+    }
+    ASSERT_EQ(rsplit(str, ", "), split(str, ", "));
+    ASSERT_EQ(rsplit(str), split(str));
+}
+
+
+/// Test the splitlines() function.
+///
+TEST(string, splitlines)
+{
+    static const string str("abc\nxyz\r\n\r\r123\n");
+    ASSERT_EQ(splitlines(str), vector<string>({"abc", "xyz", "", "", "123"}));
+    ASSERT_EQ(splitlines(str, true), vector<string>({"abc\n", "xyz\r\n", "\r", "\r", "123\n"}));
+    ASSERT_EQ(splitlines("abc"), vector<string>({"abc"}));
+    ASSERT_EQ(splitlines("\n"), vector<string>({""}));
+    ASSERT_EQ(splitlines("\n\r"), vector<string>({"", ""}));
+    ASSERT_EQ(splitlines(""), vector<string>());
+}
+
+
+/// Test the isplitlines() function.
+///
+TEST(string, isplitlines)
+{
+    // Use long lines to exercise vectorized code paths.
+    const string line(100, 'x');
+    const auto str(line + "\r\n" + line + "\r" + line);
+    ASSERT_EQ(collect(isplitlines(str)), vector<string>({line, line, line}));
+    ASSERT_EQ(collect(isplitlines(str, true)), vector<string>({line + "\r\n", line + "\r", line}));
+    ASSERT_EQ(collect(isplitlines("abc\r")), vector<string>({"abc"}));
+    ASSERT_EQ(collect(isplitlines("")), vector<string>());
+}
+
+
+/// Test the view strip functions.
+///
+TEST(string, view_strip)
+{
+    static const char* const str(" \tabc \n");
+    ASSERT_EQ(view::strip(str), "abc");
+    ASSERT_EQ(view::lstrip(str), "abc \n");
+    ASSERT_EQ(view::rstrip(str), " \tabc");
+    ASSERT_EQ(view::strip(str).data(), str + 2);
+    static constexpr CharSet chars("012");
+    ASSERT_EQ(view::strip("001122abc001122", chars), "abc");
+    ASSERT_EQ(view::strip(whitespace), "");
+    ASSERT_EQ(view::strip(""), "");
+}
+
+
+/// Test the view split functions.
+///
+TEST(string, view_split)
+{
+    static const string str(" abc, , xyz ");
+    ASSERT_EQ(view::split(str), vector<StringView>({"abc,", ",", "xyz"}));
+    ASSERT_EQ(view::split(str, ", "), vector<StringView>({" abc", "", "xyz "}));
+    ASSERT_EQ(view::split(str, ", ", 1), vector<StringView>({" abc", ", xyz "}));
+    ASSERT_EQ(view::rsplit(str), vector<StringView>({"abc,", ",", "xyz"}));
+    ASSERT_EQ(view::rsplit(str, ", ", 1), vector<StringView>({" abc, ", "xyz "}));
+    ASSERT_EQ(view::rsplit(str, 1), vector<StringView>({" abc, ,", "xyz"}));
+    ASSERT_EQ(view::splitlines("abc\r\nxyz"), vector<StringView>({"abc", "xyz"}));
+    ASSERT_EQ(view::splitlines("abc\r\nxyz", true), vector<StringView>({"abc\r\n", "xyz"}));
+    ASSERT_THROW(view::split(str, ""), invalid_argument);
+}
+
+
+/// Test the view startswith() and endswith() functions.
+///
+TEST(string, view_startswith_endswith)
+{
+    ASSERT_TRUE(view::startswith("abc", "ab"));
+    ASSERT_TRUE(view::startswith("abc", ""));
+    ASSERT_FALSE(view::startswith("abc", "abcd"));
+    ASSERT_FALSE(view::startswith("", "a"));
+    ASSERT_TRUE(view::endswith("abc", "bc"));
+    ASSERT_TRUE(view::endswith("abc", ""));
+    ASSERT_FALSE(view::endswith("abc", "xabc"));
+    ASSERT_FALSE(view::endswith("", "a"));
+}
+
+
+#if __cplusplus >= 201703L
+
+/// Test the view functions with std::string_view.
+///
+TEST(string, view_string_view)
+{
+    const std::string_view str("  abc, xyz  ");
+    const std::string_view stripped(view::strip(str));
+    ASSERT_EQ(stripped, "abc, xyz");
+    const auto items(view::split(stripped, ", "));
+    ASSERT_EQ(std::string_view(items.at(1)), "xyz");
+    ASSERT_TRUE(view::startswith(str, std::string_view("  a")));
+}
+
+#endif
+
 /**
  * Test the startswith() function.
  */
@@ -243,6 +652,103 @@ TEST(string, endswith)
 }
 
 
+/// Test the find() function.
+///
+TEST(string, find)
+{
+    ASSERT_EQ(find("abcabc", "bc"), 1);
+    ASSERT_EQ(find("abcabc", "c"), 2);
+    ASSERT_EQ(find("abcabc", ""), 0);
+    ASSERT_EQ(find("abcabc", "abcabc"), 0);
+    ASSERT_EQ(find("abcabc", "abcabcd"), -1);
+    ASSERT_EQ(find("abcabc", "xyz"), -1);
+    ASSERT_EQ(find("", ""), 0);
+    ASSERT_EQ(find(StringView(), ""), 0);
+}
+
+
+/// Test the rfind() function.
+///
+TEST(string, rfind)
+{
+    ASSERT_EQ(rfind("abcabc", "bc"), 4);
+    ASSERT_EQ(rfind("abcabc", "a"), 3);
+    ASSERT_EQ(rfind("abcabc", ""), 6);
+    ASSERT_EQ(rfind("abcabc", "abcabc"), 0);
+    ASSERT_EQ(rfind("abcabc", "abcabcd"), -1);
+    ASSERT_EQ(rfind("abcabc", "xyz"), -1);
+    ASSERT_EQ(rfind(StringView(), ""), 0);
+}
+
+
+/// Test the find() and rfind() functions for long strings.
+///
+/// This exercises the vectorized and skipping implementations for different
+/// substring lengths and alignments.
+///
+TEST(string, find_long)
+{
+    string str(1000, 'a');
+    for (const size_t len: {2, 3, 15, 16, 17, 31, 32, 33, 64, 100}) {
+        string sub(len, 'a');
+        sub.back() = 'b';
+        ASSERT_EQ(find(str, sub), -1);
+        ASSERT_EQ(rfind(str, sub), -1);
+        for (const size_t pos: {size_t(0), size_t(1), size_t(17), size_t(500), str.size() - len}) {
+            auto haystack(str);
+            haystack.replace(pos, len, sub);
+            ASSERT_EQ(find(haystack, sub), static_cast<ssize_t>(pos));
+            ASSERT_EQ(rfind(haystack, sub), static_cast<ssize_t>(pos));
+            ASSERT_EQ(find(haystack, sub), static_cast<ssize_t>(haystack.find(sub)));
+            ASSERT_EQ(rfind(haystack, sub), static_cast<ssize_t>(haystack.rfind(sub)));
+        }
+    }
+}
+
+
+/// Test the index() function.
+///
+TEST(string, index)
+{
+    ASSERT_EQ(index("abcabc", "bc"), 1);
+    ASSERT_THROW(index("abcabc", "xyz"), invalid_argument);
+}
+
+
+/// Test the rindex() function.
+///
+TEST(string, rindex)
+{
+    ASSERT_EQ(rindex("abcabc", "bc"), 4);
+    ASSERT_THROW(rindex("abcabc", "xyz"), invalid_argument);
+}
+
+
+/// Test the count() function.
+///
+TEST(string, count)
+{
+    ASSERT_EQ(count("abcabc", "bc"), 2);
+    ASSERT_EQ(count("aaaa", "aa"), 2);  // non-overlapping
+    ASSERT_EQ(count("abc", ""), 4);
+    ASSERT_EQ(count("abc", "xyz"), 0);
+    ASSERT_EQ(count("", "a"), 0);
+    ASSERT_EQ(count(StringView(), ""), 1);
+}
+
+
+/// Test the contains() function.
+///
+TEST(string, contains)
+{
+    ASSERT_TRUE(contains("abcabc", "cab"));
+    ASSERT_TRUE(contains("abcabc", ""));
+    ASSERT_FALSE(contains("abcabc", "cba"));
+    ASSERT_FALSE(contains("", "a"));
+    ASSERT_TRUE(contains(StringView(), ""));
+}
+
+
 /// Test the replace() function.
 ///
 TEST(string, replace)
@@ -257,6 +763,88 @@ TEST(string, replace)
 }
 
 
+/// Test the replace() function with different substitution lengths.
+///
+TEST(string, replace_lengths)
+{
+    ASSERT_EQ(replace("a.b.c", ".", "::"), "a::b::c");
+    ASSERT_EQ(replace("a.b.c", ".", "::", 1), "a::b.c");
+    ASSERT_EQ(replace("a::b::c", "::", "."), "a.b.c");
+    ASSERT_EQ(replace("a::b::c", "::", ".", 1), "a.b::c");
+    ASSERT_EQ(replace("a.b.c", ".", "-"), "a-b-c");
+    ASSERT_EQ(replace("aaaa", "aa", "b"), "bb");
+    ASSERT_EQ(replace("aaa", "aa", "aaa"), "aaaa");
+    ASSERT_EQ(replace("abc", "", "-", 2), "-a-bc");
+    ASSERT_EQ(replace("", "", "-"), "-");
+}
+
+
+/// Test the replace() function for multiple patterns.
+///
+TEST(string, replace_multi)
+{
+    const Replacer replacer({{"a", "1"}, {"ab", "2"}, {"bc", "3"}, {"abcd", "4"}, {"<", "&lt;"}});
+    ASSERT_EQ(replace("", replacer), "");
+    ASSERT_EQ(replace("xyz", replacer), "xyz");
+    ASSERT_EQ(replace("a", replacer), "1");
+    ASSERT_EQ(replace("ab", replacer), "2");  // longest match
+    ASSERT_EQ(replace("abc", replacer), "2c");  // leftmost match
+    ASSERT_EQ(replace("abcd", replacer), "4");
+    ASSERT_EQ(replace("abce", replacer), "2ce");
+    ASSERT_EQ(replace("xbcabcda<", replacer), "x341&lt;");
+    ASSERT_EQ(replace("aaa", replacer), "111");
+    ASSERT_EQ(replace("aaa", replacer, 2), "11a");
+    ASSERT_EQ(replace("aaa", replacer, 0), "aaa");
+}
+
+
+/// Test the Replacer class for overlapping and duplicate patterns.
+///
+TEST(string, Replacer)
+{
+    const Replacer replacer({{"he", "1"}, {"she", "2"}, {"his", "3"}, {"hers", "4"}, {"he", "5"}});
+    ASSERT_EQ(replace("ushers", replacer), "u2rs");
+    ASSERT_EQ(replace("hishe", replacer), "35");
+    ASSERT_EQ(replace("hshe", replacer), "h2");
+    ASSERT_EQ(replace("hehers", replacer), "54");
+    ASSERT_THROW(Replacer(vector<std::pair<string, string>>{{"", "x"}}), invalid_argument);
+}
+
+
+/// Test the Replacer class with every byte value in its patterns.
+///
+TEST(string, Replacer_all_bytes)
+{
+    // Hex-escape every byte, plus a longer pattern. The null byte is last so
+    // that it is the 256th distinct byte and then appears again.
+    static const char digits[] = "0123456789abcdef";
+    vector<std::pair<string, string>> subs;
+    for (size_t i(1); i <= 256; ++i) {
+        const auto c(i % 256);
+        subs.emplace_back(string(1, static_cast<char>(c)), string("\\x") + digits[c >> 4] + digits[c & 0xf]);
+    }
+    subs.emplace_back(string(2, '\0'), "<00>");
+    const Replacer replacer(subs);
+    ASSERT_EQ(replace("\x01\x01\x01", replacer), "\\x01\\x01\\x01");
+    ASSERT_EQ(replace(string("a\0\0\xff", 4), replacer), "\\x61<00>\\xff");
+    ASSERT_EQ(replace(string("\0b\0", 3), replacer), "\\x00\\x62\\x00");
+}
+
+
+/// Test the translate() function.
+///
+TEST(string, translate)
+{
+    const auto table(maketrans("abc", "xyz", "-"));
+    ASSERT_EQ(translate("aabbcc", table), "xxyyzz");
+    ASSERT_EQ(translate("a-b-c-d", table), "xyzd");
+    ASSERT_EQ(translate("", table), "");
+    ASSERT_EQ(translate("abc", TranslationTable()), "abc");
+    ASSERT_EQ(translate("a-b-c", maketrans("abc", "cab")), "c-a-b");
+    ASSERT_THROW(maketrans("abc", "xy"), invalid_argument);
+}
+
+
 /// Test the center() function.
 ///
 TEST(string, center)